@@ -0,0 +1,496 @@
+/*
+  ׼Կܣͷļ÷ʽ Google Benchmark
+    BenchSuite suite("heart", argc, argv, 2);          //  argv[2] 
+    suite.add("f", [&](bench_state& st) {
+        for (uint64_t i = 0; i < st.iterations(); i++) bench_keep(f(...));
+        st.set_items(st.iterations());
+    });
+    return suite.run();
+  ﻹ st.counter("hit_rate", x) Զֵûʡڴȣ
+  ıڸ·гJSON  Google Benchmark ûһΪֶͬ
+  
+    --format=text|json  ʽĬ text
+    --out=<ļ>         JSON дļ --format ޹أ
+    --filter=<Ӵ>     ֻưӴ
+    --min-time=<>     ÿظжãĬ 0.2
+    --repetitions=<n>   ظĬ 3λ
+    --seed=<n>          ӣĬϹ̶ֵ֤ÿͬ
+    --list              ֻг
+  ಻ -- ͷĲԼãpositional
+  ȴ 1 𰴺ʱƣֱдﵽ min-time֮ظͬһ
+  Linux  perf_event_open ʱÿβ cyclesinstructions֧뻺δУ
+  ãparanoid ƣʱʡԣӰʱ
+  JSON  context/benchmarks ṹֶͬ Google Benchmarkֱ compare.py Աν
+*/
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cpu_info.h"
+#include "gbk_utf8.h"
+
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  define BENCH_PERF 1
+#endif
+
+// Ĭӣͬһÿɵȫͬ
+const uint64_t BENCH_SEED = 0x9E3779B97F4A7C15ull;
+
+// ֹѽöɾѭ
+template <class T>
+inline void bench_keep(const T& v) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(v) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &v;
+#endif
+}
+
+// ñ vָȱֵͲǱڳļ㲻ᱻǰ
+template <class T>
+inline T bench_opaque(T v) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : "+r"(v));
+    return v;
+#else
+    volatile T t = v;
+    return t;
+#endif
+}
+
+// ڴϣñΪǰдڴ涼ᱻȡֻԵַѾݣ紫 bench_keepڴЧ
+inline void bench_clobber() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// õxorshift64*׼ʵ޹أƽ̨һ
+struct bench_rng {
+    uint64_t s;
+    explicit bench_rng(uint64_t seed) : s(seed ? seed : BENCH_SEED) {}
+    uint64_t next() {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return s * 0x2545F4914F6CDD1Dull;
+    }
+    // [lo, hi] ڵ
+    int range(int lo, int hi) {
+        return lo + static_cast<int>(next() % static_cast<uint64_t>(hi - lo + 1));
+    }
+    // [lo, hi) ڵĸ
+    double uniform(double lo, double hi) {
+        return lo + (hi - lo) * static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+// õĿ豸ͬ·һʱ
+inline FILE* bench_null_file() {
+#if defined(_WIN32)
+    static FILE* f = std::fopen("NUL", "wb");
+#else
+    static FILE* f = std::fopen("/dev/null", "wb");
+#endif
+    return f;
+}
+
+class bench_state {
+public:
+    explicit bench_state(uint64_t iters) : iters_(iters), items_(0), bytes_(0) {}
+    uint64_t iterations() const { return iters_; }
+    // һ˶/ֽڣ򲻱
+    void set_items(uint64_t n) { items_ = n; }
+    void set_bytes(uint64_t n) { bytes_ = n; }
+    // Զͬʱ
+    void counter(const std::string& name, double v) {
+        for (size_t i = 0; i < user_.size(); i++)
+            if (user_[i].first == name) {
+                user_[i].second = v;
+                return;
+            }
+        user_.push_back(std::make_pair(name, v));
+    }
+    uint64_t items() const { return items_; }
+    uint64_t bytes() const { return bytes_; }
+    const std::vector<std::pair<std::string, double> >& counters() const { return user_; }
+
+private:
+    uint64_t iters_, items_, bytes_;
+    std::vector<std::pair<std::string, double> > user_;
+};
+
+namespace bench_detail {
+
+enum { CNT_CYCLES, CNT_INSTRUCTIONS, CNT_BRANCH_MISSES, CNT_CACHE_MISSES, CNT_N };
+static const char* const counter_names[CNT_N] = {"cycles", "instructions", "branch_misses", "cache_misses"};
+
+// һӲ cycles Ϊ鳤һͣʱһȡ
+class perf_group {
+public:
+    perf_group() : ok_(false) {
+        for (int i = 0; i < CNT_N; i++) fd_[i] = -1;
+#if defined(BENCH_PERF)
+        static const uint64_t cfg[CNT_N] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                             PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES};
+        for (int i = 0; i < CNT_N; i++) {
+            perf_event_attr a;
+            std::memset(&a, 0, sizeof(a));
+            a.size = sizeof(a);
+            a.type = PERF_TYPE_HARDWARE;
+            a.config = cfg[i];
+            a.disabled = i == 0;
+            a.exclude_kernel = 1;
+            a.exclude_hv = 1;
+            a.read_format = PERF_FORMAT_GROUP;
+            fd_[i] = static_cast<int>(syscall(SYS_perf_event_open, &a, 0, -1, i ? fd_[0] : -1, 0));
+            if (fd_[i] < 0) {
+                close_all();
+                return;
+            }
+        }
+        ok_ = true;
+#endif
+    }
+    ~perf_group() { close_all(); }
+
+    bool ok() const { return ok_; }
+
+    void start() {
+#if defined(BENCH_PERF)
+        if (!ok_) return;
+        ioctl(fd_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fd_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    // ֵֹͣ
+    bool stop(uint64_t out[CNT_N]) {
+#if defined(BENCH_PERF)
+        if (!ok_) return false;
+        ioctl(fd_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t buf[1 + CNT_N];
+        if (read(fd_[0], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)) || buf[0] != CNT_N) return false;
+        for (int i = 0; i < CNT_N; i++) out[i] = buf[1 + i];
+        return true;
+#else
+        (void)out;
+        return false;
+#endif
+    }
+
+private:
+    perf_group(const perf_group&);
+    perf_group& operator=(const perf_group&);
+
+    void close_all() {
+#if defined(BENCH_PERF)
+        for (int i = CNT_N - 1; i >= 0; i--)
+            if (fd_[i] >= 0) close(fd_[i]);
+#endif
+        for (int i = 0; i < CNT_N; i++) fd_[i] = -1;
+        ok_ = false;
+    }
+
+    int  fd_[CNT_N];
+    bool ok_;
+};
+
+struct result {
+    std::string name;
+    uint64_t    iterations;
+    double      real_ns;                // еǽʱ䣨λǴΣ
+    double      cpu_ns;
+    uint64_t    items, bytes;
+    bool        has_counters;
+    double      counters[CNT_N];        // ÿεƽֵ
+    std::vector<std::pair<std::string, double> > user;
+};
+
+inline std::string json_escape(const std::string& s) {
+    std::string o;
+    for (size_t i = 0; i < s.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c == '"' || c == '\\') {
+            o += '\\';
+            o += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char tmp[8];
+            std::snprintf(tmp, sizeof(tmp), "\\u%04x", c);
+            o += tmp;
+        } else {
+            o += static_cast<char>(c);
+        }
+    }
+    return o;
+}
+
+inline std::string fmt(const char* f, double v) {
+    char tmp[64];
+    std::snprintf(tmp, sizeof(tmp), f, v);
+    return tmp;
+}
+
+// 1234567 -> "1.23M"
+inline std::string human(double v) {
+    static const char* const unit[] = {"", "k", "M", "G", "T"};
+    int k = 0;
+    while (v >= 1000.0 && k < 4) {
+        v /= 1000.0;
+        k++;
+    }
+    return fmt(v < 10 ? "%.2f" : v < 100 ? "%.1f" : "%.0f", v) + unit[k];
+}
+
+} // namespace bench_detail
+
+class BenchSuite {
+public:
+    typedef std::function<void(bench_state&)> fn;
+
+    //  argv[first] ʼprogram Ϊ JSON еĳ
+    BenchSuite(const char* program, int argc, char* argv[], int first)
+        : program_(program), json_(false), list_(false), min_time_(0.2), reps_(3), seed_(BENCH_SEED) {
+        for (int i = first; i < argc; i++) {
+            std::string a = argv[i];
+            if (a.compare(0, 2, "--") != 0) positional_.push_back(a);
+            else if (a == "--format=json") json_ = true;
+            else if (a == "--format=text") json_ = false;
+            else if (a == "--list") list_ = true;
+            else if (a.compare(0, 6, "--out=") == 0) out_ = a.substr(6);
+            else if (a.compare(0, 9, "--filter=") == 0) filter_ = a.substr(9);
+            else if (a.compare(0, 11, "--min-time=") == 0) min_time_ = std::atof(a.c_str() + 11);
+            else if (a.compare(0, 14, "--repetitions=") == 0) reps_ = std::atoi(a.c_str() + 14);
+            else if (a.compare(0, 7, "--seed=") == 0) seed_ = std::strtoull(a.c_str() + 7, 0, 0);
+            else std::fprintf(stderr, "unknown option: %s\n", a.c_str());
+        }
+        if (min_time_ <= 0) min_time_ = 0.2;
+        if (reps_ < 1) reps_ = 1;
+    }
+
+    uint64_t seed() const { return seed_; }
+    const std::vector<std::string>& positional() const { return positional_; }
+
+    void add(const std::string& name, fn f) {
+        cases_.push_back(std::make_pair(program_ + "/" + name, f));
+    }
+
+    // Уƥ filter ģ棻ֱֵΪ main ķֵ
+    int run() {
+        using namespace bench_detail;
+        if (list_) {
+            for (size_t i = 0; i < cases_.size(); i++) std::printf("%s\n", cases_[i].first.c_str());
+            return 0;
+        }
+        perf_group perf;
+        std::vector<result> res;
+        if (!json_) {
+            std::string head = context_text(perf.ok());
+            console_write(stdout, head.data(), head.size(), TEXT_LITERAL);
+            std::fflush(stdout);
+        }
+        for (size_t i = 0; i < cases_.size(); i++) {
+            if (!filter_.empty() && cases_[i].first.find(filter_) == std::string::npos) continue;
+            res.push_back(measure(cases_[i].first, cases_[i].second, perf));
+            if (!json_) {
+                std::string line = row_text(res.back());
+                console_write(stdout, line.data(), line.size(), TEXT_LITERAL);
+                std::fflush(stdout);
+            }
+        }
+        std::string js = json(res, perf.ok());
+        if (json_) std::fwrite(js.data(), 1, js.size(), stdout);
+        if (!out_.empty()) {
+            FILE* f = std::fopen(out_.c_str(), "wb");
+            if (!f || std::fwrite(js.data(), 1, js.size(), f) != js.size()) {
+                std::fprintf(stderr, "cannot write %s\n", out_.c_str());
+                if (f) std::fclose(f);
+                return 1;
+            }
+            std::fclose(f);
+        }
+        return 0;
+    }
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    struct sample {
+        double   real_ns, cpu_ns;
+        uint64_t items, bytes;
+        bool     has_counters;
+        uint64_t counters[bench_detail::CNT_N];
+        std::vector<std::pair<std::string, double> > user;
+    };
+
+    static sample once(const fn& f, uint64_t iters, bench_detail::perf_group& perf) {
+        sample s;
+        bench_state st(iters);
+        std::clock_t c0 = std::clock();
+        clock::time_point t0 = clock::now();
+        perf.start();
+        f(st);
+        s.has_counters = perf.stop(s.counters);
+        clock::time_point t1 = clock::now();
+        std::clock_t c1 = std::clock();
+        s.real_ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        s.cpu_ns = 1e9 * static_cast<double>(c1 - c0) / CLOCKS_PER_SEC;
+        s.items = st.items();
+        s.bytes = st.bytes();
+        s.user = st.counters();
+        return s;
+    }
+
+    bench_detail::result measure(const std::string& name, const fn& f, bench_detail::perf_group& perf) const {
+        using namespace bench_detail;
+        const double target = min_time_ * 1e9;
+        uint64_t iters = 1;
+        sample s = once(f, iters, perf);
+        // ѲʱƵ 40% ̵̫ĲŴ 10 
+        while (s.real_ns < target && iters < (1ull << 40)) {
+            double mul = s.real_ns / target > 0.1 ? target * 1.4 / std::max(s.real_ns, 1.0) : 10.0;
+            uint64_t next = static_cast<uint64_t>(static_cast<double>(iters) * mul);
+            iters = std::max(iters + 1, next);
+            s = once(f, iters, perf);
+        }
+        std::vector<sample> all(1, s);
+        for (int r = 1; r < reps_; r++) all.push_back(once(f, iters, perf));
+        std::sort(all.begin(), all.end(), [](const sample& a, const sample& b) { return a.real_ns < b.real_ns; });
+        const sample& m = all[all.size() / 2];
+
+        result out;
+        out.name = name;
+        out.iterations = iters;
+        out.real_ns = m.real_ns;
+        out.cpu_ns = m.cpu_ns;
+        out.items = m.items;
+        out.bytes = m.bytes;
+        out.has_counters = m.has_counters;
+        out.user = m.user;
+        for (int k = 0; k < CNT_N; k++)
+            out.counters[k] = m.has_counters ? static_cast<double>(m.counters[k]) / static_cast<double>(iters) : 0;
+        return out;
+    }
+
+    std::string context_text(bool perf_ok) const {
+        const cpu_info& ci = cpu_info_get();
+        std::string s = " " + program_ + "CPU " + (ci.brand.empty() ? ci.vendor : ci.brand) + "" +
+                        std::to_string(std::thread::hardware_concurrency()) + " ߼ˣ " +
+                        std::to_string(seed_) + "\n";
+        s += perf_ok ? "Ӳ\n" : "Ӳãperf_event_open ʧܻ Linux\n";
+#if !defined(NDEBUG)
+        s += "ע⣺δ NDEBUGǵԹֽο\n";
+#endif
+        char tmp[160];
+        std::snprintf(tmp, sizeof(tmp), "%-44s %14s %14s %12s %20s %8s\n", "Benchmark", "Time(ns/op)", "CPU(ns/op)",
+                      "Iterations", "Items/s", "IPC");
+        s += tmp;
+        s += std::string(117, '-') + "\n";
+        return s;
+    }
+
+    static std::string row_text(const bench_detail::result& r) {
+        using namespace bench_detail;
+        double n = static_cast<double>(r.iterations);
+        std::string items = r.items ? human(static_cast<double>(r.items) * 1e9 / r.real_ns) : "-";
+        if (r.bytes) items += " " + human(static_cast<double>(r.bytes) * 1e9 / r.real_ns) + "B/s";
+        std::string ipc = r.has_counters && r.counters[CNT_CYCLES] > 0
+                              ? fmt("%.2f", r.counters[CNT_INSTRUCTIONS] / r.counters[CNT_CYCLES])
+                              : "-";
+        char tmp[256];
+        std::snprintf(tmp, sizeof(tmp), "%-44s %14.2f %14.2f %12llu %20s %8s\n", r.name.c_str(), r.real_ns / n,
+                      r.cpu_ns / n, static_cast<unsigned long long>(r.iterations), items.c_str(), ipc.c_str());
+        std::string s = tmp;
+        for (size_t i = 0; i < r.user.size(); i++)
+            s += (i ? " " : "    ") + r.user[i].first + "=" + fmt("%.4g", r.user[i].second) +
+                 (i + 1 == r.user.size() ? "\n" : "");
+        return s;
+    }
+
+    std::string json(const std::vector<bench_detail::result>& res, bool perf_ok) const {
+        using namespace bench_detail;
+        const cpu_info& ci = cpu_info_get();
+        char date[32] = "";
+        std::time_t now = std::time(0);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+        std::string s = "{\n  \"context\": {\n";
+        s += "    \"date\": \"" + std::string(date) + "\",\n";
+        s += "    \"executable\": \"" + json_escape(program_) + "\",\n";
+        s += "    \"num_cpus\": " + std::to_string(std::thread::hardware_concurrency()) + ",\n";
+        s += "    \"cpu_brand\": \"" + json_escape(ci.brand.empty() ? ci.vendor : ci.brand) + "\",\n";
+#if defined(__VERSION__)
+        s += "    \"compiler\": \"" + json_escape(__VERSION__) + "\",\n";
+#elif defined(_MSC_FULL_VER)
+        s += "    \"compiler\": \"MSVC " + std::to_string(_MSC_FULL_VER) + "\",\n";
+#endif
+#if defined(NDEBUG)
+        s += "    \"library_build_type\": \"release\",\n";
+#else
+        s += "    \"library_build_type\": \"debug\",\n";
+#endif
+#if defined(BUILD_LTO)
+        s += "    \"lto\": true,\n";
+#endif
+#if defined(BUILD_PGO_GENERATE)
+        s += "    \"pgo\": \"generate\",\n";
+#elif defined(BUILD_PGO_USE)
+        s += "    \"pgo\": \"use\",\n";
+#endif
+        s += "    \"seed\": " + std::to_string(seed_) + ",\n";
+        s += "    \"min_time\": " + fmt("%g", min_time_) + ",\n";
+        s += "    \"repetitions\": " + std::to_string(reps_) + ",\n";
+        s += std::string("    \"perf_counters\": ") + (perf_ok ? "true" : "false") + "\n  },\n";
+        s += "  \"benchmarks\": [";
+        for (size_t i = 0; i < res.size(); i++) {
+            const result& r = res[i];
+            double n = static_cast<double>(r.iterations);
+            s += i ? ",\n    {" : "\n    {";
+            s += "\"name\": \"" + json_escape(r.name) + "\", \"run_name\": \"" + json_escape(r.name) + "\"";
+            s += ", \"run_type\": \"iteration\", \"repetitions\": " + std::to_string(reps_);
+            s += ", \"iterations\": " + std::to_string(r.iterations);
+            s += ", \"real_time\": " + fmt("%.4f", r.real_ns / n);
+            s += ", \"cpu_time\": " + fmt("%.4f", r.cpu_ns / n);
+            s += ", \"time_unit\": \"ns\"";
+            if (r.items) s += ", \"items_per_second\": " + fmt("%.6e", static_cast<double>(r.items) * 1e9 / r.real_ns);
+            if (r.bytes) s += ", \"bytes_per_second\": " + fmt("%.6e", static_cast<double>(r.bytes) * 1e9 / r.real_ns);
+            if (r.has_counters)
+                for (int k = 0; k < CNT_N; k++) s += std::string(", \"") + counter_names[k] + "\": " + fmt("%.3f", r.counters[k]);
+            for (size_t k = 0; k < r.user.size(); k++)
+                s += ", \"" + json_escape(r.user[k].first) + "\": " + fmt("%.6g", r.user[k].second);
+            s += "}";
+        }
+        s += "\n  ]\n}\n";
+        return s;
+    }
+
+    std::string                               program_;
+    bool                                      json_, list_;
+    std::string                               out_, filter_;
+    double                                    min_time_;
+    int                                       reps_;
+    uint64_t                                  seed_;
+    std::vector<std::string>                  positional_;
+    std::vector<std::pair<std::string, fn> >  cases_;
+};
+
+#endif
@@ -7,6 +7,7 @@
        - //汾ְ汾꣩
        - C++ ׼Ժ꣨/⣩
        - Ŀƽ̨ϵͳCPU ܹλֽ
+       - ʱ CPUSIMD չ㼶/SMT/NUMA ˣ̽ͬĿ¼ cpu_info.h
        - ׼ C ʵ
        - ã/Ż쳣/RTTISanitizerȣ
        - 빹ʱ
@@ -19,6 +20,15 @@
     g++ -std=c++17 -O2 -Wall -Wextra print_compiler_info.cpp && ./a.out
     clang++ -std=c++20 -O2 print_compiler_info.cpp && ./a.out
     cl /std:c++20 /EHsc /O2 print_compiler_info.cpp && print_compiler_info.exe
+    cmake --preset release && cmake --build --preset release && build/release/compiler_info
+      CMake ᴫ BUILD_LTO / BUILD_PGO_* ǣ桰áһھݴʾ LTOPGO ״̬
+  ׷ --bench ʱôӳ١ԭãΪǰָƣ
+    ./a.out --bench
+  ıն˱ת루ԴΪ GBKUTF-8 նϲ룬 gbk_utf8.h
+  JSON/CSV һΪ UTF-8ȡļʱҲ UTF-8 
+  ṹ߶Աȣ main ͷĲ˵
+    ./a.out --bench --format=json > baseline.json
+    ./a.out --compare=baseline.json --threshold=5
 */
 
 #include <iostream>
@@ -29,6 +39,16 @@
 #include <climits>
 #include <type_traits>
 #include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <fstream>
+#include <cctype>
+
+#include "cpu_info.h"
+#include "gbk_utf8.h"
 
 //  C++20  <version>  <bit>Ժֽ򣩡
 #if defined(__has_include)
@@ -80,7 +100,8 @@ static const char* cxx_standard_name(long v) {
     else return "δ֪/ǳϵı׼";
 }
 
-//  MSVC 汾Žӳ  
+//  MSVC 汾Žӳ  ֻ MSVC õclang-cl  Clang ֧
+#if defined(_MSC_VER) && !defined(__clang__)
 static std::string msvc_pretty_from_ver(int msc_ver) {
     // ӳ汾
     if      (msc_ver >= 1930) return "Visual Studio 2022 (v17)";
@@ -97,6 +118,7 @@ static std::string msvc_pretty_from_ver(int msc_ver) {
     else if (msc_ver >= 1200) return "Visual Studio 6.0";
     else return "ǳϵ MSVC";
 }
+#endif
 
 //  //汾̽  
 static std::string detect_compiler_name() {
@@ -414,6 +436,91 @@ static std::string detect_toolchain_flavor() {
     return oss.str();
 }
 
+//  Ŀָ -march/-m*/arch ĺ꣩  
+static std::string detect_target_isa() {
+    std::ostringstream oss;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    oss << "SSE2 ";
+#endif
+#if defined(__SSE4_2__)
+    oss << "SSE4.2 ";
+#endif
+#if defined(__POPCNT__)
+    oss << "POPCNT ";
+#endif
+#if defined(__AVX__)
+    oss << "AVX ";
+#endif
+#if defined(__AVX2__)
+    oss << "AVX2 ";
+#endif
+#if defined(__FMA__)
+    oss << "FMA ";
+#endif
+#if defined(__BMI2__)
+    oss << "BMI2 ";
+#endif
+#if defined(__AVX512F__)
+    oss << "AVX-512F ";
+#endif
+#if defined(__AVX512BW__)
+    oss << "AVX-512BW ";
+#endif
+#if defined(__AVX512VL__)
+    oss << "AVX-512VL ";
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    oss << "NEON ";
+#endif
+#if defined(__ARM_FEATURE_SVE)
+    oss << "SVE ";
+#endif
+    std::string out = oss.str();
+    if (out.empty()) return "ܹߣ";
+    return out.substr(0, out.size() - 1);
+}
+
+//  Լ죺ȱŻ/ָ־뱾 CPU ƥʱ  
+static std::vector<std::string> build_config_warnings() {
+    std::vector<std::string> w;
+#if defined(_MSC_VER) && !defined(__clang__)
+#  if defined(_DEBUG)
+    w.push_back("п⣨_DEBUGܿδʹ /O2ûвοֵ");
+#  endif
+#elif !defined(__OPTIMIZE__)
+    w.push_back("δŻȱ -O2/-O3ͨ");
+#endif
+#if defined(__NO_INLINE__) && defined(__OPTIMIZE__)
+    w.push_back("ֹ-fno-inlineȵС޷");
+#endif
+#if !defined(NDEBUG)
+    w.push_back("δ NDEBUGassert ");
+#endif
+#if __has_feature(address_sanitizer) || defined(__SANITIZE_ADDRESS__) || __has_feature(thread_sanitizer) || defined(__SANITIZE_THREAD__)
+    w.push_back(" SanitizerʺϲԹ");
+#endif
+
+    const cpu_features& f = cpu_info_get().features;
+#if defined(CPU_INFO_X86)
+    // ĿڱеӦᴥǷָ
+#  if defined(__AVX512F__)
+    if (!f.avx512f) w.push_back("ʹ AVX-512֧֣Ƿָ");
+#  endif
+#  if defined(__AVX2__)
+    if (!f.avx2) w.push_back("ʹ AVX2֧֣Ƿָ");
+#  endif
+    // Ŀڱװ׷
+#  if !defined(__AVX2__)
+    if (f.avx2) w.push_back("֧ AVX2ʱδȱ -march=native  -mavx2 -mfma");
+#  elif !defined(__AVX512F__)
+    if (f.avx512f) w.push_back("֧ AVX-512Ŀ AVX2ɿ -march=native");
+#  endif
+#else
+    (void)f;
+#endif
+    return w;
+}
+
 //  ã/Ż/쳣/RTTI/Sanitizer ȣ  
 static std::string detect_build_config() {
     std::ostringstream oss;
@@ -445,6 +552,24 @@ static std::string detect_build_config() {
     oss << "λ޹ؿִļ__PIE__ Ѷ\n";
 #endif
 
+    // 
+#if defined(__FAST_MATH__) || defined(_M_FP_FAST)
+    oss << "ٸ㣺ѿ-ffast-math  /fp:fastƫ IEEE 754\n";
+#endif
+
+    // õĿָ -march/-m*  /arch 
+    oss << "Ŀָ " << detect_target_isa() << "\n";
+
+    // LTO/PGO ûбԤֻ꣬űǣ -DBUILD_LTO=1
+#if defined(BUILD_LTO)
+    oss << "ʱŻLTOűѱǿ\n";
+#endif
+#if defined(BUILD_PGO_GENERATE)
+    oss << "PGO׮-fprofile-generate\n";
+#elif defined(BUILD_PGO_USE)
+    oss << "PGOʹòŻ-fprofile-use\n";
+#endif
+
     // 쳣
     bool exceptions_on =
 #if __has_feature(cxx_exceptions)
@@ -523,6 +648,40 @@ static std::string detect_build_config() {
     return oss.str();
 }
 
+//  ʱ CPU ̽⣨SIMD չ桢ˣ cpu_info.h  
+static std::string detect_runtime_cpu() {
+    std::ostringstream oss;
+    const cpu_info& ci = cpu_info_get();
+    const cpu_features& f = ci.features;
+    if (!ci.vendor.empty()) oss << "̣ " << ci.vendor << "\n";
+    if (!ci.brand.empty())  oss << "ͺţ " << ci.brand << "\n";
+#if defined(CPU_INFO_X86)
+    oss << "SSE2=" << yesno(f.sse2) << ", SSE3=" << yesno(f.sse3) << ", SSSE3=" << yesno(f.ssse3)
+        << ", SSE4.1=" << yesno(f.sse41) << ", SSE4.2=" << yesno(f.sse42) << ", POPCNT=" << yesno(f.popcnt) << "\n";
+    oss << "AVX=" << yesno(f.avx) << ", AVX2=" << yesno(f.avx2) << ", FMA=" << yesno(f.fma)
+        << ", BMI2=" << yesno(f.bmi2) << "\n";
+    oss << "AVX-512F=" << yesno(f.avx512f) << ", AVX-512BW=" << yesno(f.avx512bw)
+        << ", AVX-512VL=" << yesno(f.avx512vl) << ", AVX-512DQ=" << yesno(f.avx512dq) << "\n";
+#else
+    oss << "NEON=" << yesno(f.neon) << ", SVE=" << yesno(f.sve) << "\n";
+#endif
+    oss << "У " << ci.cache_line << " ֽ\n";
+    for (size_t i = 0; i < ci.caches.size(); i++) {
+        const cache_level& c = ci.caches[i];
+        oss << "L" << c.level << (c.type == 'D' ? " " : c.type == 'I' ? " ָ" : " ͳһ") << " ";
+        if (c.size >= (1u << 20) && c.size % (1u << 20) == 0) oss << (c.size >> 20) << " MiB";
+        else oss << (c.size >> 10) << " KiB";
+        if (c.ways > 0) oss << ", " << c.ways << " ·";
+        if (c.shared_by > 0) oss << ", " << c.shared_by << " ߼ CPU ";
+        oss << "\n";
+    }
+    const cpu_topology& t = ci.topology;
+    oss << "ˣ " << t.packages << " װ, " << t.cores << " , "
+        << t.logical << " ߼ CPUÿ " << t.threads_per_core() << " ̣߳, "
+        << t.numa_nodes << "  NUMA ڵ\n";
+    return oss.str();
+}
+
 //  C++ ׼Ժӡ  
 static std::string detect_cxx_features() {
     std::ostringstream oss;
@@ -631,7 +790,714 @@ static std::string detect_cxx_features() {
     return oss.str();
 }
 
-int main() {
+// ============================================================
+//  ָƣ--bench ʱУôӳ١¡ԭ
+//  ÿɴظλ p10/p90żҽ
+// ============================================================
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double seconds_since(bench_clock::time_point t0) {
+    return std::chrono::duration<double>(bench_clock::now() - t0).count();
+}
+
+// ֹŻ̶߳дԭӱ
+static std::atomic<uint64_t> g_bench_sink(0);
+
+//  رԶ汾Աȣ  
+#if defined(__clang__)
+#  define BENCH_NO_VECTORIZE_FN
+#  define BENCH_NO_VECTORIZE_LOOP _Pragma("clang loop vectorize(disable) interleave(disable)")
+#elif defined(__GNUC__)
+#  define BENCH_NO_VECTORIZE_FN __attribute__((optimize("no-tree-vectorize")))
+#  define BENCH_NO_VECTORIZE_LOOP
+#elif defined(_MSC_VER)
+#  define BENCH_NO_VECTORIZE_FN
+#  define BENCH_NO_VECTORIZE_LOOP __pragma(loop(no_vector))
+#else
+#  define BENCH_NO_VECTORIZE_FN
+#  define BENCH_NO_VECTORIZE_LOOP
+#endif
+
+struct bench_stats {
+    double median, p10, p90, best;
+};
+
+struct bench_result {
+    std::string key;        // ɶ֣ "latency.l1"
+    std::string label;      // ˿˵
+    std::string unit;       // "ns""GB/s""GFLOP/s" 
+    bool higher_better;
+    bench_stats stats;
+};
+
+static bench_stats summarize(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    bench_stats s;
+    size_t n = v.size();
+    s.median = n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+    s.p10 = v[static_cast<size_t>((n - 1) * 0.1 + 0.5)];
+    s.p90 = v[static_cast<size_t>((n - 1) * 0.9 + 0.5)];
+    s.best = v.front();
+    return s;
+}
+
+//  warmup ζ reps Σf() ÿηһֵ
+template <class F>
+static bench_stats bench_repeat(int warmup, int reps, F f) {
+    for (int i = 0; i < warmup; i++) f();
+    std::vector<double> v;
+    for (int i = 0; i < reps; i++) v.push_back(f());
+    return summarize(v);
+}
+
+static uint64_t bench_rand(uint64_t& s) {
+    s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+    return s;
+}
+
+static std::string bytes_pretty(size_t b) {
+    std::ostringstream oss;
+    if (b >= (size_t(1) << 20)) oss << (b >> 20) << " MiB";
+    else oss << (b >> 10) << " KiB";
+    return oss.str();
+}
+
+//  ָ׷ÿдһַУӲԤȡ޴  
+class pointer_chase {
+public:
+    pointer_chase(size_t bytes, size_t line) {
+        size_t n = bytes / line;
+        if (n < 16) n = 16;
+        buf_.resize(n * line);
+        std::vector<size_t> order(n);
+        for (size_t i = 0; i < n; i++) order[i] = i;
+        uint64_t seed = 0x9E3779B97F4A7C15ull;
+        for (size_t i = n - 1; i > 0; i--) {                  // Sattoloֻ֤һ
+            size_t j = static_cast<size_t>(bench_rand(seed) % i);
+            std::swap(order[i], order[j]);
+        }
+        char* base = &buf_[0];
+        for (size_t i = 0; i < n; i++) {
+            char* from = base + order[i] * line;
+            char* to = base + order[(i + 1) % n] * line;
+            std::memcpy(from, &to, sizeof(to));
+        }
+        head_ = base + order[0] * line;
+    }
+    // ÿηô
+    double run(size_t steps) {
+        char* p = head_;
+        bench_clock::time_point t0 = bench_clock::now();
+        for (size_t i = 0; i < steps; i++) p = *reinterpret_cast<char**>(p);
+        double t = seconds_since(t0);
+        g_bench_sink.store(reinterpret_cast<uintptr_t>(p), std::memory_order_relaxed);
+        return t * 1e9 / steps;
+    }
+private:
+    std::vector<char> buf_;
+    char* head_;
+};
+
+//  ںˣÿ̴߳ [lo, hi) һ  
+static uint64_t bw_read(const uint64_t* p, size_t lo, size_t hi) {
+    uint64_t a = 0, b = 0, c = 0, d = 0;
+    size_t i = lo;
+    for (; i + 4 <= hi; i += 4) { a += p[i]; b += p[i + 1]; c += p[i + 2]; d += p[i + 3]; }
+    for (; i < hi; i++) a += p[i];
+    return a + b + c + d;
+}
+static void bw_write(uint64_t* p, size_t lo, size_t hi) {
+    std::fill(p + lo, p + hi, uint64_t(0x0101010101010101ull));
+}
+static void bw_copy(uint64_t* dst, const uint64_t* src, size_t lo, size_t hi) {
+    std::memcpy(dst + lo, src + lo, (hi - lo) * sizeof(uint64_t));
+}
+
+//  threads ִ̲߳ kernel(lo, hi)ǽ߳Ⱦλͬʱ
+template <class K>
+static double run_parallel(int threads, size_t n, K kernel) {
+#if defined(HAS_HEADER_THREAD)
+    if (threads > 1) {
+        std::atomic<int> ready(0);
+        std::atomic<bool> go(false);
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; t++) {
+            size_t lo = n * t / threads, hi = n * (t + 1) / threads;
+            pool.push_back(std::thread([&, lo, hi]() {
+                ready++;
+                while (!go.load(std::memory_order_acquire)) {}
+                kernel(lo, hi);
+            }));
+        }
+        while (ready.load() < threads) {}
+        bench_clock::time_point t0 = bench_clock::now();
+        go.store(true, std::memory_order_release);
+        for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+        return seconds_since(t0);
+    }
+#endif
+    (void)threads;
+    bench_clock::time_point t0 = bench_clock::now();
+    kernel(size_t(0), n);
+    return seconds_since(t0);
+}
+
+//  £x = x*a + b ڳפ L1 飬ÿԪ 2 θ  
+BENCH_NO_VECTORIZE_FN
+static void flops_scalar(float* x, size_t n, int rounds, float a, float b) {
+    for (int r = 0; r < rounds; r++) {
+        BENCH_NO_VECTORIZE_LOOP
+        for (size_t i = 0; i < n; i++) x[i] = x[i] * a + b;
+    }
+}
+static void flops_vector(float* x, size_t n, int rounds, float a, float b) {
+    for (int r = 0; r < rounds; r++)
+        for (size_t i = 0; i < n; i++) x[i] = x[i] * a + b;
+}
+
+//  ԭã߳ fetch_add ͬһ vs Զռһ  
+struct alignas(128) padded_counter {
+    std::atomic<uint64_t> v;
+};
+
+static double atomic_ns_per_op(int threads, bool shared, uint64_t ops) {
+    std::vector<padded_counter> c(threads);
+    for (int t = 0; t < threads; t++) c[t].v.store(0);
+    double sec = run_parallel(threads, static_cast<size_t>(threads), [&](size_t lo, size_t hi) {
+        for (size_t t = lo; t < hi; t++) {
+            std::atomic<uint64_t>& a = c[shared ? 0 : t].v;
+            for (uint64_t i = 0; i < ops; i++) a.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    return sec * 1e9 / ops;
+}
+
+static std::vector<bench_result> run_benchmarks() {
+    const int warmup = 2, reps = 9;
+    std::vector<bench_result> out;
+    const cpu_info& ci = cpu_info_get();
+    const size_t line = static_cast<size_t>(ci.cache_line);
+    int threads = ci.topology.logical > 0 ? ci.topology.logical : 1;
+
+    // õĻ壺ĩ棬 64 MiB 
+    size_t llc = 0;
+    for (size_t i = 0; i < ci.caches.size(); i++)
+        if (ci.caches[i].type != 'I' && ci.caches[i].size > llc) llc = ci.caches[i].size;
+    size_t big = llc * 4;
+    if (big < (size_t(16) << 20)) big = size_t(16) << 20;
+    if (big > (size_t(64) << 20)) big = size_t(64) << 20;
+
+    // 1) ķôӳ٣ȡüһ
+    for (int level = 1; level <= 3; level++) {
+        size_t sz = ci.data_cache(level);
+        if (sz == 0 || sz / 2 >= big) continue;
+        pointer_chase pc(sz / 2, line);
+        bench_result r;
+        r.key = "latency.l" + std::to_string(level);
+        r.label = "L" + std::to_string(level) + " ôӳ٣ " + bytes_pretty(sz / 2) + "";
+        r.unit = "ns";
+        r.higher_better = false;
+        r.stats = bench_repeat(warmup, reps, [&]() { return pc.run(size_t(1) << 20); });
+        out.push_back(r);
+    }
+    {
+        pointer_chase pc(big, line);
+        bench_result r;
+        r.key = "latency.dram";
+        r.label = "ôӳ٣ " + bytes_pretty(big) + "";
+        r.unit = "ns";
+        r.higher_better = false;
+        r.stats = bench_repeat(1, reps, [&]() { return pc.run(size_t(1) << 19); });
+        out.push_back(r);
+    }
+
+    // 2) ʽ߳ȫ߼ CPU
+    size_t n = big / sizeof(uint64_t);
+    std::vector<uint64_t> src(n, 1), dst(n, 0);
+    int tcounts[2] = { 1, threads };
+    for (int k = 0; k < (threads > 1 ? 2 : 1); k++) {
+        int t = tcounts[k];
+        std::string sfx = t == 1 ? "1t" : "mt";
+        std::string who = t == 1 ? "߳" : std::to_string(t) + " ߳";
+        const double gb = big / 1e9;
+        bench_result r;
+        r.unit = "GB/s";
+        r.higher_better = true;
+
+        r.key = "bandwidth.read." + sfx;
+        r.label = who + "˳";
+        r.stats = bench_repeat(warmup, reps, [&]() {
+            double s = run_parallel(t, n, [&](size_t lo, size_t hi) { g_bench_sink.store(bw_read(&src[0], lo, hi), std::memory_order_relaxed); });
+            return gb / s;
+        });
+        out.push_back(r);
+
+        r.key = "bandwidth.write." + sfx;
+        r.label = who + "˳д";
+        r.stats = bench_repeat(warmup, reps, [&]() {
+            return gb / run_parallel(t, n, [&](size_t lo, size_t hi) { bw_write(&dst[0], lo, hi); });
+        });
+        out.push_back(r);
+
+        r.key = "bandwidth.copy." + sfx;
+        r.label = who + "ƴ+д";
+        r.stats = bench_repeat(warmup, reps, [&]() {
+            return 2 * gb / run_parallel(t, n, [&](size_t lo, size_t hi) { bw_copy(&dst[0], &src[0], lo, hi); });
+        });
+        out.push_back(r);
+    }
+
+    // 3) £Զ
+    {
+        const size_t fn = 2048;                 // 8 KiBפ L1
+        const int rounds = 2000;
+        std::vector<float> x(fn, 1.0f);
+        const double flop = 2.0 * fn * rounds;
+        bench_result r;
+        r.unit = "GFLOP/s";
+        r.higher_better = true;
+        r.key = "flops.scalar";
+        r.label = "ȸ£";
+        r.stats = bench_repeat(warmup, reps, [&]() {
+            bench_clock::time_point t0 = bench_clock::now();
+            flops_scalar(&x[0], fn, rounds, 0.999f, 0.001f);
+            return flop / seconds_since(t0) / 1e9;
+        });
+        out.push_back(r);
+        r.key = "flops.vector";
+        r.label = "ȸ£Զ";
+        r.stats = bench_repeat(warmup, reps, [&]() {
+            bench_clock::time_point t0 = bench_clock::now();
+            flops_vector(&x[0], fn, rounds, 0.999f, 0.001f);
+            return flop / seconds_since(t0) / 1e9;
+        });
+        out.push_back(r);
+        g_bench_sink.store(static_cast<uint64_t>(x[fn / 2]), std::memory_order_relaxed);
+    }
+
+    // 4) ԭӲ̻߳ߡ̸߳Լ߳ͬһ
+    {
+        const uint64_t ops = 1000000;
+        bench_result r;
+        r.unit = "ns";
+        r.higher_better = false;
+        r.key = "atomic.uncontended";
+        r.label = "ԭӼӣ̣߳";
+        r.stats = bench_repeat(warmup, reps, [&]() { return atomic_ns_per_op(1, true, ops); });
+        out.push_back(r);
+        if (threads > 1) {
+            r.key = "atomic.private." + std::to_string(threads) + "t";
+            r.label = "ԭӼӣ" + std::to_string(threads) + " ̣߳ԶռУ";
+            r.stats = bench_repeat(warmup, reps, [&]() { return atomic_ns_per_op(threads, false, ops); });
+            out.push_back(r);
+            r.key = "atomic.contended." + std::to_string(threads) + "t";
+            r.label = "ԭӼӣ" + std::to_string(threads) + " ̣߳ͬһ";
+            r.stats = bench_repeat(warmup, reps, [&]() { return atomic_ns_per_op(threads, true, ops); });
+            out.push_back(r);
+        }
+    }
+    return out;
+}
+
+static std::string format_benchmarks(const std::vector<bench_result>& v) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < v.size(); i++) {
+        const bench_result& r = v[i];
+        oss << r.label << " " << r.stats.median << " " << r.unit
+            << "p10=" << r.stats.p10 << ", p90=" << r.stats.p90 << "\n";
+    }
+    return oss.str();
+}
+
+// ============================================================
+//  ṹ--format=json / --format=csv߶Աȣ--compare=ļ
+//  Ϊ̶Ӣĵ֣ڴռֵø detect_* ԭ
+// ============================================================
+
+struct info_field {
+    std::string key;
+    std::string value;
+};
+
+static std::string trim_newlines(std::string s) {
+    while (!s.empty() && (s[s.size() - 1] == '\n' || s[s.size() - 1] == '\r')) s.erase(s.size() - 1);
+    return s;
+}
+
+static std::vector<info_field> collect_fields() {
+    std::vector<info_field> v;
+    struct adder {
+        std::vector<info_field>& v;
+        void operator()(const std::string& k, const std::string& val) {
+            info_field f = { k, trim_newlines(val) };
+            v.push_back(f);
+        }
+    } add = { v };
+    std::ostringstream tmp;
+
+    add("compiler.name", detect_compiler_name());
+    add("compiler.version", detect_compiler_version());
+    add("build.date", std::string(__DATE__) + " " + __TIME__);
+    add("build.config", detect_build_config());
+    add("build.isa", detect_target_isa());
+    std::vector<std::string> warnings = build_config_warnings();
+    std::string joined;
+    for (size_t i = 0; i < warnings.size(); i++) joined += (i ? "\n" : "") + warnings[i];
+    add("build.warnings", joined);
+    add("platform.os", detect_os());
+    add("platform.arch", detect_arch());
+    add("platform.pointer_bits", std::to_string(detect_pointer_bits()));
+    add("platform.endianness", detect_endianness());
+#if defined(HAS_HEADER_THREAD)
+    add("platform.hardware_concurrency", std::to_string(std::thread::hardware_concurrency()));
+#endif
+    add("stdlib.cpp", detect_cpp_stdlib());
+    add("stdlib.c", detect_c_libc());
+    add("cxx.features", detect_cxx_features());
+    add("toolchain.flavor", detect_toolchain_flavor());
+#if defined(__GXX_ABI_VERSION)
+    add("abi.gxx", std::to_string(__GXX_ABI_VERSION));
+#endif
+    add("datamodel.sizeof_pointer", std::to_string(sizeof(void*)));
+    add("datamodel.sizeof_long", std::to_string(sizeof(long)));
+    add("datamodel.sizeof_size_t", std::to_string(sizeof(size_t)));
+    add("datamodel.char_signed", static_cast<char>(-1) < 0 ? "true" : "false");
+
+    const cpu_info& ci = cpu_info_get();
+    const cpu_features& f = ci.features;
+    add("cpu.vendor", ci.vendor);
+    add("cpu.brand", ci.brand);
+    const struct { const char* name; bool on; } feats[] = {
+        { "sse2", f.sse2 }, { "sse3", f.sse3 }, { "ssse3", f.ssse3 }, { "sse4_1", f.sse41 },
+        { "sse4_2", f.sse42 }, { "popcnt", f.popcnt }, { "avx", f.avx }, { "avx2", f.avx2 },
+        { "fma", f.fma }, { "bmi2", f.bmi2 }, { "avx512f", f.avx512f }, { "avx512bw", f.avx512bw },
+        { "avx512vl", f.avx512vl }, { "avx512dq", f.avx512dq }, { "neon", f.neon }, { "sve", f.sve },
+    };
+    for (size_t i = 0; i < sizeof(feats) / sizeof(feats[0]); i++)
+        add(std::string("cpu.feature.") + feats[i].name, feats[i].on ? "true" : "false");
+    add("cpu.cache_line", std::to_string(ci.cache_line));
+    for (size_t i = 0; i < ci.caches.size(); i++) {
+        const cache_level& c = ci.caches[i];
+        std::string k = "cpu.cache.l" + std::to_string(c.level) + (c.type == 'D' ? "d" : c.type == 'I' ? "i" : "");
+        add(k + ".size", std::to_string(c.size));
+        add(k + ".ways", std::to_string(c.ways));
+        add(k + ".shared_by", std::to_string(c.shared_by));
+    }
+    add("cpu.topology.packages", std::to_string(ci.topology.packages));
+    add("cpu.topology.cores", std::to_string(ci.topology.cores));
+    add("cpu.topology.logical", std::to_string(ci.topology.logical));
+    add("cpu.topology.numa_nodes", std::to_string(ci.topology.numa_nodes));
+    return v;
+}
+
+static std::string json_escape(const std::string& s) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < s.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        switch (c) {
+        case '"':  oss << "\\\""; break;
+        case '\\': oss << "\\\\"; break;
+        case '\n': oss << "\\n"; break;
+        case '\r': oss << "\\r"; break;
+        case '\t': oss << "\\t"; break;
+        default:
+            if (c < 0x20) oss << "\\u00" << "0123456789abcdef"[c >> 4] << "0123456789abcdef"[c & 15];
+            else oss << s[i];
+        }
+    }
+    return oss.str();
+}
+
+static std::string csv_escape(const std::string& s) {
+    if (s.find_first_of(",\"\r\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '"') out += '"';
+        out += s[i];
+    }
+    return out + "\"";
+}
+
+static std::string format_json(const std::vector<info_field>& fields, const std::vector<bench_result>& bench) {
+    std::ostringstream oss;
+    oss << std::setprecision(6);
+    oss << "{\n  \"fields\": {";
+    for (size_t i = 0; i < fields.size(); i++)
+        oss << (i ? ",\n    " : "\n    ") << "\"" << json_escape(fields[i].key) << "\": \""
+            << json_escape(fields[i].value) << "\"";
+    oss << "\n  },\n  \"bench\": {";
+    for (size_t i = 0; i < bench.size(); i++) {
+        const bench_result& r = bench[i];
+        oss << (i ? ",\n    " : "\n    ") << "\"" << json_escape(r.key) << "\": {\"median\": " << r.stats.median
+            << ", \"p10\": " << r.stats.p10 << ", \"p90\": " << r.stats.p90
+            << ", \"unit\": \"" << json_escape(r.unit) << "\", \"higher_better\": "
+            << (r.higher_better ? "true" : "false") << "}";
+    }
+    oss << "\n  }\n}\n";
+    return oss.str();
+}
+
+// ÿУkind,key,value,unit,p10,p90,higher_betterkind Ϊ field  bench
+static std::string format_csv(const std::vector<info_field>& fields, const std::vector<bench_result>& bench) {
+    std::ostringstream oss;
+    oss << std::setprecision(6);
+    oss << "kind,key,value,unit,p10,p90,higher_better\n";
+    for (size_t i = 0; i < fields.size(); i++)
+        oss << "field," << csv_escape(fields[i].key) << "," << csv_escape(fields[i].value) << ",,,,\n";
+    for (size_t i = 0; i < bench.size(); i++) {
+        const bench_result& r = bench[i];
+        oss << "bench," << csv_escape(r.key) << "," << r.stats.median << "," << csv_escape(r.unit) << ","
+            << r.stats.p10 << "," << r.stats.p90 << "," << (r.higher_better ? "true" : "false") << "\n";
+    }
+    return oss.str();
+}
+
+//  ȡߣܱ JSON  CSV  
+struct baseline {
+    std::vector<info_field>   fields;
+    std::vector<bench_result> bench;
+};
+
+// ֻǱԼ JSON Ӽַ֡true/false
+class mini_json_reader {
+public:
+    explicit mini_json_reader(const std::string& s) : s_(s), p_(0), ok_(true) {}
+    bool read(baseline& b) {
+        if (!expect('{')) return false;
+        while (ok_ && !peek('}')) {
+            std::string section = str();
+            expect(':');
+            if (section == "fields") read_fields(b);
+            else if (section == "bench") read_bench(b);
+            else ok_ = false;
+            if (!peek('}')) expect(',');
+        }
+        return ok_ && expect('}');
+    }
+private:
+    void ws() { while (p_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[p_]))) p_++; }
+    bool peek(char c) { ws(); return p_ < s_.size() && s_[p_] == c; }
+    bool expect(char c) {
+        if (peek(c)) { p_++; return true; }
+        ok_ = false;
+        return false;
+    }
+    std::string str() {
+        std::string out;
+        if (!expect('"')) return out;
+        while (p_ < s_.size() && s_[p_] != '"') {
+            char c = s_[p_++];
+            if (c == '\\' && p_ < s_.size()) {
+                char e = s_[p_++];
+                if (e == 'n') c = '\n';
+                else if (e == 'r') c = '\r';
+                else if (e == 't') c = '\t';
+                else if (e == 'u' && p_ + 4 <= s_.size()) { c = static_cast<char>(std::strtol(s_.substr(p_, 4).c_str(), 0, 16)); p_ += 4; }
+                else c = e;
+            }
+            out += c;
+        }
+        expect('"');
+        return out;
+    }
+    std::string scalar() {
+        ws();
+        if (peek('"')) return str();
+        size_t q = p_;
+        while (q < s_.size() && s_[q] != ',' && s_[q] != '}' && !std::isspace(static_cast<unsigned char>(s_[q]))) q++;
+        std::string out = s_.substr(p_, q - p_);
+        p_ = q;
+        return out;
+    }
+    void read_fields(baseline& b) {
+        expect('{');
+        while (ok_ && !peek('}')) {
+            info_field f;
+            f.key = str();
+            expect(':');
+            f.value = scalar();
+            b.fields.push_back(f);
+            if (!peek('}')) expect(',');
+        }
+        expect('}');
+    }
+    void read_bench(baseline& b) {
+        expect('{');
+        while (ok_ && !peek('}')) {
+            bench_result r;
+            r.key = str();
+            r.higher_better = true;
+            r.stats.median = r.stats.p10 = r.stats.p90 = r.stats.best = 0;
+            expect(':');
+            expect('{');
+            while (ok_ && !peek('}')) {
+                std::string k = str();
+                expect(':');
+                std::string v = scalar();
+                if (k == "median") r.stats.median = std::atof(v.c_str());
+                else if (k == "p10") r.stats.p10 = std::atof(v.c_str());
+                else if (k == "p90") r.stats.p90 = std::atof(v.c_str());
+                else if (k == "unit") r.unit = v;
+                else if (k == "higher_better") r.higher_better = v == "true";
+                if (!peek('}')) expect(',');
+            }
+            expect('}');
+            b.bench.push_back(r);
+            if (!peek('}')) expect(',');
+        }
+        expect('}');
+    }
+
+    const std::string& s_;
+    size_t p_;
+    bool ok_;
+};
+
+static std::vector<std::string> csv_split(const std::string& text, size_t& p) {
+    std::vector<std::string> cols(1);
+    bool quoted = false;
+    for (; p < text.size(); p++) {
+        char c = text[p];
+        if (quoted) {
+            if (c == '"' && p + 1 < text.size() && text[p + 1] == '"') { cols.back() += '"'; p++; }
+            else if (c == '"') quoted = false;
+            else cols.back() += c;
+        } else if (c == '"') quoted = true;
+        else if (c == ',') cols.push_back(std::string());
+        else if (c == '\n') { p++; break; }
+        else if (c != '\r') cols.back() += c;
+    }
+    return cols;
+}
+
+static bool load_baseline(const std::string& path, baseline& b) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) return false;
+    std::ostringstream buf;
+    buf << in.rdbuf();
+    std::string text = transcode(buf.str(), TEXT_UTF8, TEXT_LITERAL);   // ļ UTF-8ڲֶΰԴ
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first != std::string::npos && text[first] == '{') {
+        mini_json_reader rd(text);
+        return rd.read(b);
+    }
+    size_t p = 0;
+    csv_split(text, p);                                 // ͷ
+    while (p < text.size()) {
+        std::vector<std::string> c = csv_split(text, p);
+        if (c.size() < 7) continue;
+        if (c[0] == "field") {
+            info_field f = { c[1], c[2] };
+            b.fields.push_back(f);
+        } else if (c[0] == "bench") {
+            bench_result r;
+            r.key = c[1];
+            r.unit = c[3];
+            r.higher_better = c[6] == "true";
+            r.stats.median = std::atof(c[2].c_str());
+            r.stats.p10 = std::atof(c[4].c_str());
+            r.stats.p90 = std::atof(c[5].c_str());
+            r.stats.best = r.stats.median;
+            b.bench.push_back(r);
+        }
+    }
+    return true;
+}
+
+// ԱȣϢֶα仯жǷ˲ֵٷֱȣ
+// ˲
+static int compare_with_baseline(const baseline& base, const std::vector<info_field>& fields,
+                                 const std::vector<bench_result>& bench, double threshold, std::ostream& os) {
+    int regressions = 0;
+    os << " ߶Աȣֵ " << threshold << "% \n";
+    for (size_t i = 0; i < base.fields.size(); i++) {
+        const info_field& b = base.fields[i];
+        if (b.key == "build.date") continue;                // ÿι
+        bool found = false;
+        for (size_t k = 0; k < fields.size(); k++) {
+            if (fields[k].key != b.key) continue;
+            found = true;
+            if (fields[k].value != b.value)
+                os << "[仯] " << b.key << " " << b.value << "  " << fields[k].value << "\n";
+        }
+        if (!found) os << "[ȱʧ] " << b.key << "\n";
+    }
+    os << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < base.bench.size(); i++) {
+        const bench_result& b = base.bench[i];
+        const bench_result* cur = 0;
+        for (size_t k = 0; k < bench.size(); k++)
+            if (bench[k].key == b.key) cur = &bench[k];
+        if (!cur) {
+            os << "[ȱʧ] " << b.key << "\n";
+            continue;
+        }
+        if (b.stats.median == 0) continue;
+        double pct = (cur->stats.median - b.stats.median) / b.stats.median * 100.0;
+        double worse = b.higher_better ? -pct : pct;
+        const char* tag = worse > threshold ? "[˲]" : worse < -threshold ? "[]" : "[ƽ]";
+        if (worse > threshold) regressions++;
+        os << tag << " " << b.key << " " << b.stats.median << "  " << cur->stats.median << " " << b.unit
+           << "" << (pct >= 0 ? "+" : "") << pct << "%\n";
+    }
+    os << "˲ " << regressions << "\n";
+    return regressions;
+}
+
+int main(int argc, char* argv[]) {
+    // 
+    //   --bench            ܻ׼ʱ룩
+    //   --format=json|csv  ṹĬΪ˿ı
+    //   --compare=ļ     ֮ǰ JSON/CSV ߶Աȣ˲ʱ 1
+    //   --threshold=ٷֱ Աʱж˲ֵĬ 10
+    ConsoleText console;
+    bool want_bench = false;
+    std::string format = "text", compare_path;
+    double threshold = 10.0;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--bench") want_bench = true;
+        else if (a.compare(0, 9, "--format=") == 0) format = a.substr(9);
+        else if (a.compare(0, 10, "--compare=") == 0) compare_path = a.substr(10);
+        else if (a.compare(0, 12, "--threshold=") == 0) threshold = std::atof(a.c_str() + 12);
+        else {
+            std::cerr << "δ֪ " << a << "\n";
+            return 2;
+        }
+    }
+    if (format != "text" && format != "json" && format != "csv") {
+        std::cerr << "δ֪ʽ " << format << "\n";
+        return 2;
+    }
+
+    if (format != "text" || !compare_path.empty()) {
+        baseline base;
+        if (!compare_path.empty()) {
+            if (!load_baseline(compare_path, base)) {
+                std::cerr << "޷ȡߣ " << compare_path << "\n";
+                return 2;
+            }
+            if (!base.bench.empty()) want_bench = true;     // ݾҪ²
+        }
+        std::vector<info_field> fields = collect_fields();
+        std::vector<bench_result> bench;
+        if (want_bench) bench = run_benchmarks();
+        if (format != "text") {
+            // ṹ̶Ϊ UTF-8ƹնתֱд
+            std::string out = format == "json" ? format_json(fields, bench) : format_csv(fields, bench);
+            out = transcode(out, TEXT_LITERAL, TEXT_UTF8);
+            std::cout.flush();
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            std::fflush(stdout);
+        }
+        if (compare_path.empty()) return 0;
+        // ṹռñ׼ʱԱȱд׼
+        std::ostream& os = format == "text" ? std::cout : std::cerr;
+        return compare_with_baseline(base, fields, bench, threshold, os) > 0 ? 1 : 0;
+    }
+
     std::cout << "================ 뻷Ϣ ================\n";
 
     // 
@@ -659,6 +1525,10 @@ int main() {
 #endif
     std::cout << "\n";
 
+    // ʱ CPUʵĿ겻ͬ
+    std::cout << " ʱ CPU \n";
+    std::cout << detect_runtime_cpu() << "\n";
+
     // ׼ C 
     std::cout << " ׼ C ʱ \n";
     std::cout << "C++ ׼⣺ " << detect_cpp_stdlib() << "\n";
@@ -671,7 +1541,12 @@ int main() {
 
     // 
     std::cout << "  \n";
-    std::cout << detect_build_config() << "\n";
+    std::cout << detect_build_config();
+    std::vector<std::string> warnings = build_config_warnings();
+    for (size_t i = 0; i < warnings.size(); i++)
+        std::cout << "!!! 棺" << warnings[i] << "\n";
+    if (warnings.empty()) std::cout << "Լ죺δ\n";
+    std::cout << "\n";
 
     // /
     std::cout << " ζ \n";
@@ -688,6 +1563,11 @@ int main() {
               << ", sizeof(size_t)=" << sizeof(size_t) << "\n";
     std::cout << "char Ƿзţʵֶ壩 " << yesno(static_cast<char>(-1) < 0) << "\n";
 
+    if (want_bench) {
+        std::cout << "\n ܻ׼λ 2 Ρ 9 Σ \n";
+        std::cout << format_benchmarks(run_benchmarks());
+    }
+
     std::cout << "==================================================\n";
     return 0;
 }
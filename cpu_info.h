@@ -0,0 +1,365 @@
+/*
+  ʱ CPU Ϣ̽⣨ͷļ
+    - SIMD չx86  CPUID + XGETBVͬʱȷϲϵͳѿ YMM/ZMM ״̬棩
+      ARM  auxv  HWCAP
+    - 棺Спȡ߼ CPU 
+      Linux  /sys/devices/system/cpu/cpu0/cacheWindows  GetLogicalProcessorInformation
+       x86 ƽ̨˻ CPUID leaf 4
+    - ˣ߼ CPUġװۣNUMA ڵ
+   compiler_info.cpp бڵ detect_* ͬشą̇̄ʵִʲô
+  cpu_info_get() ״εʱ̽⣬֮󷵻ػ
+*/
+#ifndef CPU_INFO_H
+#define CPU_INFO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define CPU_INFO_X86 1
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#endif
+#if defined(_WIN32)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#endif
+#if defined(__linux__)
+#  include <unistd.h>
+#  if defined(__aarch64__) || defined(__arm__)
+#    include <sys/auxv.h>
+#  endif
+#endif
+
+struct cpu_features {
+    bool sse2, sse3, ssse3, sse41, sse42, popcnt;
+    bool avx, avx2, fma, bmi2;
+    bool avx512f, avx512bw, avx512vl, avx512dq;
+    bool neon, sve;
+};
+
+struct cache_level {
+    int         level;          // 1/2/3...
+    char        type;           // 'D' , 'I' ָ, 'U' ͳһ
+    std::size_t size;           // ֽ
+    int         line;           // пֽڣ
+    int         ways;           // ȣ0 ʾδ֪
+    int         shared_by;      // û߼ CPU 0 ʾδ֪
+};
+
+struct cpu_topology {
+    int logical;                // ߼ CPUӲ̣߳
+    int cores;                  // 
+    int packages;               // װ/
+    int numa_nodes;
+    int threads_per_core() const { return cores > 0 ? logical / cores : 1; }
+};
+
+struct cpu_info {
+    std::string              vendor;
+    std::string              brand;
+    cpu_features             features;
+    std::vector<cache_level> caches;
+    int                      cache_line;    // ڲݻп
+    cpu_topology             topology;
+
+    // ȡ level ݣͳһĴСδ̽⵽ʱ 0
+    std::size_t data_cache(int level) const {
+        for (std::size_t i = 0; i < caches.size(); i++)
+            if (caches[i].level == level && caches[i].type != 'I') return caches[i].size;
+        return 0;
+    }
+};
+
+namespace cpu_info_detail {
+
+#if defined(CPU_INFO_X86)
+inline void cpuid(unsigned leaf, unsigned sub, unsigned r[4]) {
+#  if defined(_MSC_VER)
+    int v[4];
+    __cpuidex(v, static_cast<int>(leaf), static_cast<int>(sub));
+    for (int i = 0; i < 4; i++) r[i] = static_cast<unsigned>(v[i]);
+#  else
+    if (!__get_cpuid_count(leaf, sub, &r[0], &r[1], &r[2], &r[3])) r[0] = r[1] = r[2] = r[3] = 0;
+#  endif
+}
+
+// XCR0ϵͳлʱЩĴ״̬
+inline uint64_t xgetbv0() {
+#  if defined(_MSC_VER)
+    return _xgetbv(0);
+#  else
+    unsigned lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+#  endif
+}
+
+inline void detect_x86(cpu_info& ci) {
+    unsigned r[4];
+    cpuid(0, 0, r);
+    unsigned max_leaf = r[0];
+    char vendor[13];
+    std::memcpy(vendor + 0, &r[1], 4);
+    std::memcpy(vendor + 4, &r[3], 4);
+    std::memcpy(vendor + 8, &r[2], 4);
+    vendor[12] = 0;
+    ci.vendor = vendor;
+
+    cpuid(0x80000000u, 0, r);
+    if (r[0] >= 0x80000004u) {
+        char brand[49];
+        for (unsigned k = 0; k < 3; k++) {
+            cpuid(0x80000002u + k, 0, r);
+            std::memcpy(brand + 16 * k, r, 16);
+        }
+        brand[48] = 0;
+        const char* b = brand;
+        while (*b == ' ') b++;
+        ci.brand = b;
+    }
+
+    cpu_features& f = ci.features;
+    if (max_leaf < 1) return;
+    cpuid(1, 0, r);
+    unsigned ecx1 = r[2], edx1 = r[3];
+    f.sse2   = (edx1 >> 26) & 1;
+    f.sse3   = (ecx1 >> 0) & 1;
+    f.ssse3  = (ecx1 >> 9) & 1;
+    f.sse41  = (ecx1 >> 19) & 1;
+    f.sse42  = (ecx1 >> 20) & 1;
+    f.popcnt = (ecx1 >> 23) & 1;
+    bool osxsave = (ecx1 >> 27) & 1;
+    uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+    bool ymm_ok = (xcr0 & 0x6) == 0x6;              // XMM + YMM
+    bool zmm_ok = ymm_ok && (xcr0 & 0xE0) == 0xE0;  // opmask + ZMM_Hi256 + Hi16_ZMM
+    f.avx = ymm_ok && ((ecx1 >> 28) & 1);
+    f.fma = f.avx && ((ecx1 >> 12) & 1);
+    if (max_leaf >= 7) {
+        cpuid(7, 0, r);
+        unsigned ebx7 = r[1];
+        f.avx2     = f.avx && ((ebx7 >> 5) & 1);
+        f.bmi2     = (ebx7 >> 8) & 1;
+        f.avx512f  = zmm_ok && ((ebx7 >> 16) & 1);
+        f.avx512dq = f.avx512f && ((ebx7 >> 17) & 1);
+        f.avx512bw = f.avx512f && ((ebx7 >> 30) & 1);
+        f.avx512vl = f.avx512f && ((ebx7 >> 31) & 1);
+    }
+}
+
+// Intel Ϊ leaf 4AMD Ϊ 0x8000001D߸ʽͬ
+inline void caches_from_cpuid(cpu_info& ci) {
+    unsigned r[4];
+    cpuid(0, 0, r);
+    unsigned leaf = 4;
+    if (ci.vendor == "AuthenticAMD" || ci.vendor == "HygonGenuine") {
+        leaf = 0x8000001Du;
+        cpuid(0x80000000u, 0, r);
+        if (r[0] < leaf) return;
+    } else if (r[0] < 4) {
+        return;
+    }
+    for (unsigned sub = 0; sub < 16; sub++) {
+        cpuid(leaf, sub, r);
+        unsigned t = r[0] & 0x1F;
+        if (t == 0) break;
+        cache_level c;
+        c.level     = static_cast<int>((r[0] >> 5) & 0x7);
+        c.type      = t == 1 ? 'D' : t == 2 ? 'I' : 'U';
+        c.line      = static_cast<int>((r[1] & 0xFFF) + 1);
+        c.ways      = static_cast<int>(((r[1] >> 22) & 0x3FF) + 1);
+        c.shared_by = static_cast<int>(((r[0] >> 14) & 0xFFF) + 1);
+        unsigned parts = ((r[1] >> 12) & 0x3FF) + 1;
+        c.size = static_cast<std::size_t>(c.ways) * parts * c.line * (r[2] + 1);
+        ci.caches.push_back(c);
+    }
+}
+#endif
+
+#if defined(__linux__)
+inline bool read_line(const std::string& path, std::string& out) {
+    std::ifstream in(path.c_str());
+    if (!in || !std::getline(in, out)) return false;
+    return true;
+}
+
+//  "0-3,8,10-11" ʽ CPU б
+inline std::vector<int> parse_cpu_list(const std::string& s) {
+    std::vector<int> out;
+    std::size_t p = 0;
+    while (p < s.size()) {
+        std::size_t q = s.find(',', p);
+        if (q == std::string::npos) q = s.size();
+        std::string part = s.substr(p, q - p);
+        std::size_t dash = part.find('-');
+        if (!part.empty()) {
+            int a = std::atoi(part.c_str());
+            int b = dash == std::string::npos ? a : std::atoi(part.c_str() + dash + 1);
+            for (int i = a; i <= b; i++) out.push_back(i);
+        }
+        p = q + 1;
+    }
+    return out;
+}
+
+inline std::size_t parse_size(const std::string& s) {
+    std::size_t v = static_cast<std::size_t>(std::strtoull(s.c_str(), 0, 10));
+    if (s.find('K') != std::string::npos) v <<= 10;
+    else if (s.find('M') != std::string::npos) v <<= 20;
+    else if (s.find('G') != std::string::npos) v <<= 30;
+    return v;
+}
+
+inline void caches_from_sysfs(cpu_info& ci) {
+    const std::string base = "/sys/devices/system/cpu/cpu0/cache/index";
+    for (int idx = 0; idx < 16; idx++) {
+        std::string dir = base + std::to_string(idx) + "/", s;
+        if (!read_line(dir + "level", s)) break;
+        cache_level c;
+        c.level = std::atoi(s.c_str());
+        c.type  = 'U';
+        if (read_line(dir + "type", s)) c.type = s == "Data" ? 'D' : s == "Instruction" ? 'I' : 'U';
+        c.size      = read_line(dir + "size", s) ? parse_size(s) : 0;
+        c.line      = read_line(dir + "coherency_line_size", s) ? std::atoi(s.c_str()) : 0;
+        c.ways      = read_line(dir + "ways_of_associativity", s) ? std::atoi(s.c_str()) : 0;
+        c.shared_by = read_line(dir + "shared_cpu_list", s) ? static_cast<int>(parse_cpu_list(s).size()) : 0;
+        ci.caches.push_back(c);
+    }
+}
+
+inline void topology_from_sysfs(cpu_info& ci) {
+    std::string s;
+    std::vector<int> cpus;
+    if (read_line("/sys/devices/system/cpu/online", s)) cpus = parse_cpu_list(s);
+    std::set<std::pair<int, int> > cores;
+    std::set<int> packages;
+    for (std::size_t i = 0; i < cpus.size(); i++) {
+        std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpus[i]) + "/topology/";
+        int pkg = read_line(dir + "physical_package_id", s) ? std::atoi(s.c_str()) : 0;
+        int core = read_line(dir + "core_id", s) ? std::atoi(s.c_str()) : cpus[i];
+        packages.insert(pkg);
+        cores.insert(std::make_pair(pkg, core));
+    }
+    cpu_topology& t = ci.topology;
+    if (!cpus.empty()) t.logical = static_cast<int>(cpus.size());
+    if (!cores.empty()) t.cores = static_cast<int>(cores.size());
+    if (!packages.empty()) t.packages = static_cast<int>(packages.size());
+    if (read_line("/sys/devices/system/node/online", s)) t.numa_nodes = static_cast<int>(parse_cpu_list(s).size());
+}
+#endif
+
+#if defined(_WIN32)
+inline void detect_windows(cpu_info& ci) {
+    DWORD len = 0;
+    GetLogicalProcessorInformation(0, &len);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> v(len / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (v.empty() || !GetLogicalProcessorInformation(&v[0], &len)) return;
+    cpu_topology& t = ci.topology;
+    t.logical = t.cores = t.packages = t.numa_nodes = 0;
+    for (std::size_t i = 0; i < v.size(); i++) {
+        int bits = 0;
+        for (ULONG_PTR m = v[i].ProcessorMask; m; m &= m - 1) bits++;
+        switch (v[i].Relationship) {
+        case RelationProcessorCore:
+            t.cores++;
+            t.logical += bits;
+            break;
+        case RelationProcessorPackage:
+            t.packages++;
+            break;
+        case RelationNumaNode:
+            t.numa_nodes++;
+            break;
+        case RelationCache: {
+            const CACHE_DESCRIPTOR& d = v[i].Cache;
+            cache_level c;
+            c.level     = d.Level;
+            c.type      = d.Type == CacheData ? 'D' : d.Type == CacheInstruction ? 'I' : 'U';
+            c.size      = d.Size;
+            c.line      = d.LineSize;
+            c.ways      = d.Associativity == CACHE_FULLY_ASSOCIATIVE ? 0 : d.Associativity;
+            c.shared_by = bits;
+            // ÿĸһ˽л棬ֻһ
+            bool dup = false;
+            for (std::size_t k = 0; k < ci.caches.size(); k++)
+                if (ci.caches[k].level == c.level && ci.caches[k].type == c.type) dup = true;
+            if (!dup) ci.caches.push_back(c);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+#endif
+
+inline cpu_info detect() {
+    cpu_info ci;
+    std::memset(&ci.features, 0, sizeof(ci.features));
+    ci.cache_line = 0;
+    ci.topology.logical = ci.topology.cores = ci.topology.packages = ci.topology.numa_nodes = 1;
+#if defined(__linux__)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n > 0) ci.topology.logical = ci.topology.cores = static_cast<int>(n);
+#endif
+
+#if defined(CPU_INFO_X86)
+    detect_x86(ci);
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    ci.vendor = "ARM64";
+    ci.features.neon = true;                        // AArch64 ر ASIMD
+#  if defined(__linux__) && defined(AT_HWCAP)
+    ci.features.sve = (getauxval(AT_HWCAP) >> 22) & 1;   // HWCAP_SVE
+#  endif
+#elif defined(__arm__)
+    ci.vendor = "ARM";
+#  if defined(__linux__) && defined(AT_HWCAP)
+    ci.features.neon = (getauxval(AT_HWCAP) >> 12) & 1;  // HWCAP_NEON
+#  endif
+#endif
+
+#if defined(__linux__)
+    caches_from_sysfs(ci);
+    topology_from_sysfs(ci);
+#elif defined(_WIN32)
+    detect_windows(ci);
+#endif
+#if defined(CPU_INFO_X86)
+    if (ci.caches.empty()) caches_from_cpuid(ci);
+#endif
+
+    for (std::size_t i = 0; i < ci.caches.size(); i++) {
+        const cache_level& c = ci.caches[i];
+        if (c.type != 'I' && c.line > 0 && (ci.cache_line == 0 || c.level == 1)) ci.cache_line = c.line;
+    }
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_LINESIZE)
+    if (ci.cache_line == 0) {
+        long l = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+        if (l > 0) ci.cache_line = static_cast<int>(l);
+    }
+#endif
+    if (ci.cache_line == 0) ci.cache_line = 64;
+    return ci;
+}
+
+} // namespace cpu_info_detail
+
+// ̽һΣ֮󷵻ͬһݽC++11 ֲ̬ʼ̰߳ȫ
+inline const cpu_info& cpu_info_get() {
+    static const cpu_info ci = cpu_info_detail::detect();
+    return ci;
+}
+
+#endif
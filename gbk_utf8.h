@@ -0,0 +1,370 @@
+/*
+  GBK  UTF-8 תԼݴ˹Ŀ̨㣨ͷļ
+    - gbk_to_utf8 / utf8_to_gbkת룻ASCII  SSE2 ÿμ鲢 16 ֽ
+    - console_encodingնʹõı루Windows ̨ҳϵͳ LC_ALL/LC_CTYPE/LANG
+       CONSOLE_ENCODING=gbk|utf8 ǿָ
+    - console_writeһΰԴıתն˱д
+    - ConsoleText main ͷһcout/cerr  cin Զֱת
+      ߱ͬʱʲôҲ
+  ֿԴļ GBKֱ UTF-8 ն˻룻е iconv ̫
+*/
+#ifndef GBK_UTF8_H
+#define GBK_UTF8_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "gbk_table.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define GBK_UTF8_SSE2 1
+#endif
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#endif
+
+enum text_encoding {
+    TEXT_UTF8,
+    TEXT_GBK
+};
+
+// 뵥Ԫַı룺һ GBK ռ 2 ֽڣUTF-8 ռ 3 ֽ
+const text_encoding TEXT_LITERAL = sizeof("") == 3 ? TEXT_GBK : TEXT_UTF8;
+
+// һתĽдֽĩβȱַ룬һ
+struct transcode_result {
+    size_t in, out;
+};
+
+namespace gbk_utf8_detail {
+
+//  s  ASCII ֽڵĸͬʱ out
+inline size_t copy_ascii(const char* s, size_t n, char* out) {
+    size_t i = 0;
+#if defined(GBK_UTF8_SSE2)
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        int m = _mm_movemask_epi8(v);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), v);
+        if (m) {
+#if defined(__GNUC__) || defined(__clang__)
+            return i + __builtin_ctz(static_cast<unsigned>(m));
+#else
+            unsigned long k;
+            _BitScanForward(&k, static_cast<unsigned long>(m));
+            return i + k;
+#endif
+        }
+    }
+#endif
+    for (; i < n && !(static_cast<unsigned char>(s[i]) & 0x80); i++) out[i] = s[i];
+    return i;
+}
+
+inline char* put_utf8(char* o, uint32_t cp) {
+    if (cp < 0x80) {
+        *o++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *o++ = static_cast<char>(0xC0 | (cp >> 6));
+        *o++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *o++ = static_cast<char>(0xE0 | (cp >> 12));
+        *o++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *o++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return o;
+}
+
+// GBK ˫ֽڶӦ UTF-8 ֽڣ 3 ֽڣڴ˳볤ȣֽڣΪ 0 ʾδ
+inline const uint32_t* gbk_utf8_bytes() {
+    static const std::vector<uint32_t> table = [] {
+        std::vector<uint32_t> t(126 * 191, 0);
+        for (int i = 0; i < 126 * 191; i++) {
+            if (!gbk_table[i]) continue;
+            char b[4] = { 0, 0, 0, 0 };
+            uint32_t len = static_cast<uint32_t>(put_utf8(b, gbk_table[i]) - b);
+            uint32_t v;
+            std::memcpy(&v, b, 4);
+            t[i] = v | (len << 24);
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+// Unicodeƽ棩 GBK ķ״ʹʱ
+inline const uint16_t* ucs_to_gbk() {
+    static const std::vector<uint16_t> table = [] {
+        std::vector<uint16_t> t(0x10000, 0);
+        for (int i = 0; i < 126 * 191; i++) {
+            uint16_t u = gbk_table[i];
+            if (u && !t[u]) t[u] = static_cast<uint16_t>(((0x81 + i / 191) << 8) | (0x40 + i % 191));
+        }
+        t[0x20AC] = 0x80;                       // CP936 ѵֽ 0x80 ΪŷԪ
+        return t;
+    }();
+    return table.data();
+}
+
+} // namespace gbk_utf8_detail
+
+// GBK  UTF-8out Ҫ 3*n ֽڡǷֽ U+FFFD
+// final Ϊʱĩβֽڲ루ʽתʱһ飩
+inline transcode_result gbk_to_utf8(const char* in, size_t n, char* out, bool final = true) {
+    using namespace gbk_utf8_detail;
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(in);
+    const uint32_t* tab = gbk_utf8_bytes();
+    size_t i = 0;
+    char* o = out;
+    while (i < n) {
+        size_t a = copy_ascii(in + i, n - i, o);
+        i += a;
+        o += a;
+        // ķ ASCII ﴦٻص ASCII ·
+        while (i < n && s[i] >= 0x80) {
+            unsigned c = s[i];
+            if (c >= 0x81 && c <= 0xFE && i + 1 < n) {
+                unsigned d = s[i + 1];
+                uint32_t v = d >= 0x40 && d <= 0xFE ? tab[(c - 0x81) * 191 + (d - 0x40)] : 0;
+                if (v) {
+                    //  4 ֽдٰʵʳǰ÷֤ 3*n Ŀռ䣬Խ
+                    std::memcpy(o, &v, 4);
+                    o += v >> 24;
+                    i += 2;
+                    continue;
+                }
+            } else if (c >= 0x81 && c <= 0xFE && !final) {
+                break;
+            }
+            o = put_utf8(o, c == 0x80 ? 0x20AC : 0xFFFD);
+            i++;
+        }
+        if (i + 1 == n && s[i] >= 0x81 && !final) break;   // ĩβֽڣһ
+    }
+    transcode_result r = { i, static_cast<size_t>(o - out) };
+    return r;
+}
+
+// UTF-8  GBKout Ҫ n ֽڡGBK ûеַͷǷ '?'
+inline transcode_result utf8_to_gbk(const char* in, size_t n, char* out, bool final = true) {
+    using namespace gbk_utf8_detail;
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(in);
+    const uint16_t* rev = ucs_to_gbk();
+    size_t i = 0;
+    char* o = out;
+    while (i < n) {
+        size_t a = copy_ascii(in + i, n - i, o);
+        i += a;
+        o += a;
+        if (i >= n) break;
+        unsigned c = s[i];
+        int len = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+        if (len > 1 && i + len > n && !final) break;
+        uint32_t cp = 0;
+        bool ok = len > 1 && i + len <= n;
+        if (ok) {
+            cp = c & (0x7F >> len);
+            for (int k = 1; k < len; k++) {
+                ok = ok && (s[i + k] & 0xC0) == 0x80;
+                cp = (cp << 6) | (s[i + k] & 0x3F);
+            }
+        }
+        if (!ok) {
+            *o++ = '?';
+            i++;
+            continue;
+        }
+        uint16_t g = cp < 0x10000 ? rev[cp] : 0;
+        if (g > 0xFF) {
+            *o++ = static_cast<char>(g >> 8);
+            *o++ = static_cast<char>(g & 0xFF);
+        } else {
+            *o++ = g ? static_cast<char>(g) : '?';
+        }
+        i += len;
+    }
+    transcode_result r = { i, static_cast<size_t>(o - out) };
+    return r;
+}
+
+// תıݰ汾from  to ͬʱԭ
+inline std::string transcode(const std::string& s, text_encoding from, text_encoding to) {
+    if (from == to) return s;
+    std::string out(from == TEXT_GBK ? s.size() * 3 : s.size(), '\0');
+    transcode_result r = from == TEXT_GBK ? gbk_to_utf8(s.data(), s.size(), &out[0])
+                                          : utf8_to_gbk(s.data(), s.size(), &out[0]);
+    out.resize(r.out);
+    return out;
+}
+
+// ն˱룬ֻжһ
+inline text_encoding console_encoding() {
+    static const text_encoding enc = [] {
+        const char* force = std::getenv("CONSOLE_ENCODING");
+        if (force) {
+            if (!std::strcmp(force, "gbk") || !std::strcmp(force, "GBK")) return TEXT_GBK;
+            if (!std::strcmp(force, "utf8") || !std::strcmp(force, "UTF-8")) return TEXT_UTF8;
+        }
+#ifdef _WIN32
+        return GetConsoleOutputCP() == 65001 ? TEXT_UTF8 : TEXT_GBK;
+#else
+        const char* names[] = { "LC_ALL", "LC_CTYPE", "LANG" };
+        for (const char* name : names) {
+            const char* v = std::getenv(name);
+            if (!v || !*v) continue;
+            std::string s(v);
+            for (char& ch : s) ch = static_cast<char>(ch >= 'a' && ch <= 'z' ? ch - 32 : ch);
+            if (s.find("GBK") != std::string::npos || s.find("GB18030") != std::string::npos ||
+                s.find("GB2312") != std::string::npos)
+                return TEXT_GBK;
+            return TEXT_UTF8;
+        }
+        return TEXT_UTF8;
+#endif
+    }();
+    return enc;
+}
+
+// һԴ루fromıն˱д f
+inline bool console_write(FILE* f, const char* s, size_t n, text_encoding from = TEXT_LITERAL) {
+    text_encoding to = console_encoding();
+    if (from == to) return std::fwrite(s, 1, n, f) == n;
+    std::vector<char> out(from == TEXT_GBK ? n * 3 : n);
+    transcode_result r = from == TEXT_GBK ? gbk_to_utf8(s, n, out.data()) : utf8_to_gbk(s, n, out.data());
+    return std::fwrite(out.data(), 1, r.out, f) == r.out;
+}
+
+// һת뽻ԭ streambuf
+class transcode_outbuf : public std::streambuf {
+public:
+    // from Ϊд뷽ı룬Ϊһ
+    transcode_outbuf(std::streambuf* dst, text_encoding from) : dst_(dst), from_(from) {
+        setp(buf_, buf_ + sizeof(buf_));
+    }
+    ~transcode_outbuf() { drain(true); }
+
+protected:
+    int_type overflow(int_type c) {
+        if (!drain(false)) return traits_type::eof();
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+    int sync() { return drain(false) && dst_->pubsync() == 0 ? 0 : -1; }
+
+private:
+    bool drain(bool final) {
+        size_t n = static_cast<size_t>(pptr() - pbase());
+        if (!n) return true;
+        tmp_.resize(from_ == TEXT_GBK ? n * 3 : n);
+        transcode_result r = from_ == TEXT_GBK ? gbk_to_utf8(buf_, n, &tmp_[0], final)
+                                               : utf8_to_gbk(buf_, n, &tmp_[0], final);
+        bool ok = dst_->sputn(tmp_.data(), static_cast<std::streamsize>(r.out)) == static_cast<std::streamsize>(r.out);
+        size_t rest = n - r.in;                 // ȱַǰֽڣŲ忪ͷ
+        std::memmove(buf_, buf_ + r.in, rest);
+        setp(buf_, buf_ + sizeof(buf_));
+        pbump(static_cast<int>(rest));
+        return ok;
+    }
+
+    std::streambuf* dst_;
+    text_encoding   from_;
+    char            buf_[8192];
+    std::string     tmp_;
+};
+
+// 뷽򣺰дԭ streambuf 벢ת룬ʱһ
+class transcode_inbuf : public std::streambuf {
+public:
+    // from Ϊݵı룬ȡһ
+    transcode_inbuf(std::streambuf* src, text_encoding from) : src_(src), from_(from) {
+        setg(0, 0, 0);
+    }
+
+protected:
+    int_type underflow() {
+        if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+        bool eof = false;
+        for (;;) {
+            int_type c = src_->sbumpc();
+            if (traits_type::eq_int_type(c, traits_type::eof())) {
+                eof = true;
+                break;
+            }
+            raw_.push_back(traits_type::to_char_type(c));
+            if (c == '\n' || raw_.size() >= 4096) break;
+        }
+        if (raw_.empty()) return traits_type::eof();
+        out_.resize(from_ == TEXT_GBK ? raw_.size() * 3 : raw_.size());
+        transcode_result r = from_ == TEXT_GBK ? gbk_to_utf8(raw_.data(), raw_.size(), &out_[0], eof)
+                                               : utf8_to_gbk(raw_.data(), raw_.size(), &out_[0], eof);
+        raw_.erase(0, r.in);
+        out_.resize(r.out);
+        if (out_.empty()) return eof ? traits_type::eof() : underflow();
+        setg(&out_[0], &out_[0], &out_[0] + out_.size());
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    std::streambuf* src_;
+    text_encoding   from_;
+    std::string     raw_, out_;
+};
+
+//  main ͷһԴն˱벻ͬʱӹ cout/cerr/cin Ļ岢Զת룬ʱԭ
+class ConsoleText {
+public:
+    explicit ConsoleText(text_encoding source = TEXT_LITERAL)
+        : out_(0), err_(0), in_(0), old_out_(0), old_err_(0), old_in_(0) {
+        text_encoding term = console_encoding();
+        if (source == term) return;
+        std::cout.flush();
+        std::cerr.flush();
+        old_out_ = std::cout.rdbuf();
+        old_err_ = std::cerr.rdbuf();
+        old_in_  = std::cin.rdbuf();
+        out_ = new transcode_outbuf(old_out_, source);
+        err_ = new transcode_outbuf(old_err_, source);
+        in_  = new transcode_inbuf(old_in_, term);
+        std::cout.rdbuf(out_);
+        std::cerr.rdbuf(err_);
+        std::cin.rdbuf(in_);
+    }
+    ~ConsoleText() {
+        if (!out_) return;
+        std::cout.flush();
+        std::cerr.flush();
+        std::cout.rdbuf(old_out_);
+        std::cerr.rdbuf(old_err_);
+        std::cin.rdbuf(old_in_);
+        delete out_;
+        delete err_;
+        delete in_;
+    }
+
+private:
+    ConsoleText(const ConsoleText&);
+    ConsoleText& operator=(const ConsoleText&);
+
+    transcode_outbuf* out_;
+    transcode_outbuf* err_;
+    transcode_inbuf*  in_;
+    std::streambuf*   old_out_;
+    std::streambuf*   old_err_;
+    std::streambuf*   old_in_;
+};
+
+#endif
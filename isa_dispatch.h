@@ -0,0 +1,85 @@
+/*
+  ָɣͷļͬһں˱汾ߡNEONAVX2AVX-512
+  ʱ cpu_info.h ʱִ̽е߰汾ָ룬
+  ֮ÿεֻһμת
+
+  ÷
+    ISA_TARGET_AVX2 static void k_avx2(...) { ... ʹ AVX2 ڽ ... }
+    static void k_base(...) { ... }
+    static void (* const k)(...) = isa_select(isa_detect(), k_base, 0, k_avx2, 0);
+
+  GCC/Clang  __attribute__((target)) һ뵥Ԫɸ汾Ҫѡ
+  MSVC ֱʹøڽû ifuncΪֻ ELF/glibc Ͽá
+  û ISA_LEVEL=baseline|neon|avx2|avx512 ǿƽڶԱŴ
+*/
+#ifndef ISA_DISPATCH_H
+#define ISA_DISPATCH_H
+
+#include <cstdlib>
+#include <cstring>
+
+#include "cpu_info.h"
+
+enum isa_level {
+    ISA_BASELINE = 0,
+    ISA_NEON,
+    ISA_AVX2,
+    ISA_AVX512
+};
+
+#if defined(CPU_INFO_X86) && (defined(__GNUC__) || defined(__clang__))
+#  define ISA_X86_VARIANTS 1
+#  define ISA_TARGET_AVX2   __attribute__((target("avx2,fma")))
+#  define ISA_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl,avx2,fma")))
+#elif defined(CPU_INFO_X86) && defined(_MSC_VER)
+#  define ISA_X86_VARIANTS 1
+#  define ISA_TARGET_AVX2
+#  define ISA_TARGET_AVX512
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#  define ISA_NEON_VARIANTS 1
+#endif
+
+inline const char* isa_name(isa_level l) {
+    switch (l) {
+    case ISA_NEON:   return "NEON";
+    case ISA_AVX2:   return "AVX2";
+    case ISA_AVX512: return "AVX-512";
+    default:         return "baseline";
+    }
+}
+
+// õ߼𣬿ɱ ISA_LEVEL ѹ̧ͣߣ
+inline isa_level isa_detect() {
+    const cpu_features& f = cpu_info_get().features;
+    isa_level best = ISA_BASELINE;
+    if (f.neon) best = ISA_NEON;
+    if (f.avx2 && f.fma) best = ISA_AVX2;
+    if (f.avx512f && f.avx512bw && f.avx512vl) best = ISA_AVX512;
+
+    const char* env = std::getenv("ISA_LEVEL");
+    if (env) {
+        isa_level want = best;
+        if (std::strcmp(env, "baseline") == 0) want = ISA_BASELINE;
+        else if (std::strcmp(env, "neon") == 0) want = ISA_NEON;
+        else if (std::strcmp(env, "avx2") == 0) want = ISA_AVX2;
+        else if (std::strcmp(env, "avx512") == 0) want = ISA_AVX512;
+        if (want < best) best = want;
+    }
+    return best;
+}
+
+// Ӻѡʵѡ level һûжӦʵֵļ 0
+// chosen ǿʱдʵѡеļ
+template <class Fn>
+inline Fn isa_select(isa_level level, Fn baseline, Fn neon, Fn avx2, Fn avx512, isa_level* chosen = 0) {
+    Fn fn = baseline;
+    isa_level got = ISA_BASELINE;
+    if (level == ISA_NEON && neon) { fn = neon; got = ISA_NEON; }
+    if (level >= ISA_AVX2 && avx2) { fn = avx2; got = ISA_AVX2; }
+    if (level >= ISA_AVX512 && avx512) { fn = avx512; got = ISA_AVX512; }
+    if (chosen) *chosen = got;
+    return fn;
+}
+
+#endif
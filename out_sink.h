@@ -0,0 +1,206 @@
+/*
+  ͷļû̬Ĵ󻺳ֻʽ flush д
+    -  std::to_chars ʽ locale  iostream ĸʽ״̬
+    - дʱ gbk_utf8.h  console_write תն˱
+    - async Ϊʱɺ̸̨߳дǰ̨д flush ʱѻ彻ȥһյļд
+  ַ putchar printf endl ʱ仨 write ϵͳϣ
+  һ֡һݱдһεþ͹ˡ
+  һ OutSink ֻӦһ߳ʹã cout/printf ʱ flush˳ҡ
+  ҪתʱתַֽӦд루write  <<Ҫɵֽ put
+*/
+#ifndef OUT_SINK_H
+#define OUT_SINK_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__has_include)
+#  if __has_include(<charconv>) && __cplusplus >= 201703L
+#    include <charconv>
+#    define OUT_SINK_CHARCONV 1
+#  endif
+#endif
+
+#include "gbk_utf8.h"
+
+class OutSink {
+public:
+    // f ΪĿļcap ΪСenc Ϊдݵı
+    explicit OutSink(FILE* f = stdout, size_t cap = 1 << 16, bool async = false, text_encoding enc = TEXT_LITERAL)
+        : f_(f), cap_(cap < 256 ? 256 : cap), enc_(enc), async_(async), busy_(false), stop_(false), writes_(0) {
+        buf_.reserve(cap_);
+        if (async_) {
+            spare_.reserve(cap_);
+            writer_ = std::thread(&OutSink::writer_loop, this);
+        }
+    }
+
+    ~OutSink() {
+        flush();
+        if (async_) {
+            {
+                std::unique_lock<std::mutex> lk(mu_);
+                idle_.wait(lk, [this] { return !busy_; });
+                stop_ = true;
+            }
+            ready_.notify_one();
+            writer_.join();
+        }
+    }
+
+    OutSink& put(char c) {
+        if (buf_.size() >= cap_) flush();
+        buf_.push_back(c);
+        return *this;
+    }
+
+    OutSink& write(const char* s, size_t n) {
+        if (buf_.size() + n > cap_) {
+            flush();
+            if (n > cap_) {                     // 廹ֱд
+                if (async_) wait_idle();
+                emit(s, n);
+                return *this;
+            }
+        }
+        buf_.insert(buf_.end(), s, s + n);
+        return *this;
+    }
+
+    OutSink& repeat(char c, size_t n) {
+        while (n) {
+            if (buf_.size() >= cap_) flush();
+            size_t k = cap_ - buf_.size() < n ? cap_ - buf_.size() : n;
+            buf_.insert(buf_.end(), k, c);
+            n -= k;
+        }
+        return *this;
+    }
+
+    OutSink& operator<<(char c)               { return put(c); }
+    OutSink& operator<<(const char* s)        { return write(s, std::strlen(s)); }
+    OutSink& operator<<(const std::string& s) { return write(s.data(), s.size()); }
+
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value && !std::is_same<T, bool>::value,
+                            OutSink&>::type
+    operator<<(T v) {
+        char tmp[24];
+#if defined(OUT_SINK_CHARCONV)
+        char* e = std::to_chars(tmp, tmp + sizeof(tmp), v).ptr;
+        return write(tmp, static_cast<size_t>(e - tmp));
+#else
+        int n = std::is_signed<T>::value ? std::snprintf(tmp, sizeof(tmp), "%lld", static_cast<long long>(v))
+                                         : std::snprintf(tmp, sizeof(tmp), "%llu", static_cast<unsigned long long>(v));
+        return write(tmp, static_cast<size_t>(n));
+#endif
+    }
+
+    //  ostream Ĭϸʽͬ6 λЧֵͨøʽ
+    OutSink& operator<<(double v) { return general(v, 6); }
+
+    // ͨøʽprec λЧ֣൱ setprecision(prec)
+    OutSink& general(double v, int prec) {
+        char tmp[64];
+#if defined(OUT_SINK_CHARCONV) && defined(__cpp_lib_to_chars)
+        char* e = std::to_chars(tmp, tmp + sizeof(tmp), v, std::chars_format::general, prec).ptr;
+        return write(tmp, static_cast<size_t>(e - tmp));
+#else
+        int n = std::snprintf(tmp, sizeof(tmp), "%.*g", prec, v);
+        return write(tmp, static_cast<size_t>(n));
+#endif
+    }
+
+    // ʽС prec λ൱ fixed << setprecision(prec)
+    OutSink& fixed(double v, int prec) {
+        char tmp[352];
+#if defined(OUT_SINK_CHARCONV) && defined(__cpp_lib_to_chars)
+        char* e = std::to_chars(tmp, tmp + sizeof(tmp), v, std::chars_format::fixed, prec).ptr;
+        return write(tmp, static_cast<size_t>(e - tmp));
+#else
+        int n = std::snprintf(tmp, sizeof(tmp), "%.*f", prec, v);
+        return write(tmp, static_cast<size_t>(n));
+#endif
+    }
+
+    // ʽд㣺ͬģʽдˢ£첽ģʽ½̨̺߳
+    void flush() {
+        if (buf_.empty()) return;
+        if (!async_) {
+            emit(buf_.data(), buf_.size());
+            buf_.clear();
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            idle_.wait(lk, [this] { return !busy_; });
+            buf_.swap(spare_);
+            busy_ = true;
+        }
+        ready_.notify_one();
+        buf_.clear();
+    }
+
+    // ȵǰݶд
+    void sync() {
+        flush();
+        if (async_) wait_idle();
+    }
+
+    size_t pending() const { return buf_.size(); }
+    size_t writes() const  { return writes_; }   // ʵдں˶ϵͳǷ
+
+private:
+    OutSink(const OutSink&);
+    OutSink& operator=(const OutSink&);
+
+    void emit(const char* s, size_t n) {
+        console_write(f_, s, n, enc_);
+        std::fflush(f_);
+        writes_++;
+    }
+
+    void wait_idle() {
+        std::unique_lock<std::mutex> lk(mu_);
+        idle_.wait(lk, [this] { return !busy_; });
+    }
+
+    void writer_loop() {
+        std::unique_lock<std::mutex> lk(mu_);
+        for (;;) {
+            ready_.wait(lk, [this] { return busy_ || stop_; });
+            if (busy_) {
+                lk.unlock();
+                emit(spare_.data(), spare_.size());
+                spare_.clear();
+                lk.lock();
+                busy_ = false;
+                idle_.notify_all();
+                continue;
+            }
+            if (stop_) return;
+        }
+    }
+
+    FILE*                   f_;
+    size_t                  cap_;
+    text_encoding           enc_;
+    bool                    async_;
+    std::vector<char>       buf_;               // ǰ̨дĻ
+    std::vector<char>       spare_;             // 첽ģʽ½̵̨߳Ļ
+    std::mutex              mu_;
+    std::condition_variable ready_, idle_;
+    bool                    busy_, stop_;       // busy_spare_ дд
+    std::atomic<size_t>     writes_;
+    std::thread             writer_;
+};
+
+#endif
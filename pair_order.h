@@ -0,0 +1,205 @@
+/*
+  ɶСģ磨ͷļ ñȴС.cpp  change() 汾
+    - cswap޷֧ıȽϽκο < ȽϵͶ
+    - order_pairs / order_pairs_interleavedһϰAVX2 ÿ 8 
+    - network_sort<N>N=2..16  Batcher ż鲢磬Ƚ޹
+    - sort_groups<N>ԴСAVX2  8 ͬʱͬһ
+  ݣȱȽתдԼһԤʧܣȫΪȡ min/max
+  ںͨ isa_dispatch.h ʱѡ汾
+*/
+#ifndef PAIR_ORDER_H
+#define PAIR_ORDER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "isa_dispatch.h"
+#if defined(ISA_X86_VARIANTS)
+#  include <immintrin.h>
+#endif
+
+// ޷֧ȽϽ a <= bͻͶת
+template <class T>
+inline void cswap(T& a, T& b) {
+    bool gt = b < a;
+    T lo = gt ? b : a;
+    T hi = gt ? a : b;
+    a = lo;
+    b = hi;
+}
+
+// ԶȽϵİ汾 !less(b, a)
+template <class T, class Less>
+inline void cswap(T& a, T& b, Less less) {
+    bool gt = less(b, a);
+    T lo = gt ? b : a;
+    T hi = gt ? a : b;
+    a = lo;
+    b = hi;
+}
+
+// 飺a[i] ȡСߣb[i] ȡ
+template <class T>
+inline void order_pairs(T* a, T* b, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) cswap(a[i], b[i]);
+}
+
+//  Batcher ż鲢磺ɱȽ 
+template <int N>
+struct sort_network {
+    static_assert(N >= 2 && N <= 16, "sort_network supports 2..16 elements");
+    unsigned char lo[80], hi[80];
+    int size;
+
+    constexpr sort_network() : lo(), hi(), size(0) {
+        int p2 = 1;
+        while (p2 < N) p2 <<= 1;
+        for (int p = 1; p < p2; p <<= 1)
+            for (int k = p; k >= 1; k >>= 1)
+                for (int j = k % p; j + k < p2; j += 2 * k)
+                    for (int i = 0; i < k && i + j + k < p2; i++)
+                        // ±곬 N λΪ +ޣ֮صıȽֱȥ
+                        if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < N) {
+                            lo[size] = static_cast<unsigned char>(i + j);
+                            hi[size] = static_cast<unsigned char>(i + j + k);
+                            size++;
+                        }
+    }
+};
+
+// ԭ N Ԫ
+template <int N, class T>
+inline void network_sort(T* v) {
+    static constexpr sort_network<N> net;
+    for (int c = 0; c < net.size; c++) cswap(v[net.lo[c]], v[net.hi[c]]);
+}
+
+template <int N, class T, class Less>
+inline void network_sort(T* v, Less less) {
+    static constexpr sort_network<N> net;
+    for (int c = 0; c < net.size; c++) cswap(v[net.lo[c]], v[net.hi[c]], less);
+}
+
+namespace pair_order_detail {
+
+inline void order_pairs_i32_base(int32_t* a, int32_t* b, std::size_t n) {
+    order_pairs(a, b, n);
+}
+
+inline void order_pairs_xy_base(int32_t* xy, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) cswap(xy[2 * i], xy[2 * i + 1]);
+}
+
+template <int N>
+inline void sort_groups_base(int32_t* data, std::size_t groups) {
+    for (std::size_t g = 0; g < groups; g++) network_sort<N>(data + g * N);
+}
+
+#if defined(ISA_X86_VARIANTS)
+ISA_TARGET_AVX2
+inline void order_pairs_i32_avx2(int32_t* a, int32_t* b, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), _mm256_min_epi32(va, vb));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i), _mm256_max_epi32(va, vb));
+    }
+    for (; i < n; i++) cswap(a[i], b[i]);
+}
+
+// ŵ (x,y) ԣÿڲȡ min/maxżλȡСλȡ
+ISA_TARGET_AVX2
+inline void order_pairs_xy_avx2(int32_t* xy, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(xy + 2 * i));
+        __m256i s = _mm256_shuffle_epi32(v, 0xB1);
+        __m256i r = _mm256_blend_epi32(_mm256_min_epi32(v, s), _mm256_max_epi32(v, s), 0xAA);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(xy + 2 * i), r);
+    }
+    for (; i < n; i++) cswap(xy[2 * i], xy[2 * i + 1]);
+}
+
+// 8 һţתóɡ k Ԫص 8 顱һһĴÿȽһ min/max
+template <int N>
+ISA_TARGET_AVX2
+inline void sort_groups_avx2(int32_t* data, std::size_t groups) {
+    static constexpr sort_network<N> net;
+    alignas(32) int32_t col[N][8];
+    std::size_t g = 0;
+    for (; g + 8 <= groups; g += 8) {
+        const int32_t* src = data + g * N;
+        for (int l = 0; l < 8; l++)
+            for (int k = 0; k < N; k++) col[k][l] = src[l * N + k];
+        __m256i r[N];
+        for (int k = 0; k < N; k++) r[k] = _mm256_load_si256(reinterpret_cast<const __m256i*>(col[k]));
+        for (int c = 0; c < net.size; c++) {
+            __m256i x = r[net.lo[c]], y = r[net.hi[c]];
+            r[net.lo[c]] = _mm256_min_epi32(x, y);
+            r[net.hi[c]] = _mm256_max_epi32(x, y);
+        }
+        for (int k = 0; k < N; k++) _mm256_store_si256(reinterpret_cast<__m256i*>(col[k]), r[k]);
+        int32_t* dst = data + g * N;
+        for (int l = 0; l < 8; l++)
+            for (int k = 0; k < N; k++) dst[l * N + k] = col[k][l];
+    }
+    for (; g < groups; g++) network_sort<N>(data + g * N);
+}
+#endif
+
+typedef void (*pairs_fn)(int32_t*, int32_t*, std::size_t);
+typedef void (*pairs_xy_fn)(int32_t*, std::size_t);
+typedef void (*groups_fn)(int32_t*, std::size_t);
+
+inline pairs_fn pick_pairs() {
+    pairs_fn avx2 = 0;
+#if defined(ISA_X86_VARIANTS)
+    avx2 = order_pairs_i32_avx2;
+#endif
+    return isa_select(isa_detect(), order_pairs_i32_base, pairs_fn(0), avx2, avx2);
+}
+inline pairs_xy_fn pick_pairs_xy() {
+    pairs_xy_fn avx2 = 0;
+#if defined(ISA_X86_VARIANTS)
+    avx2 = order_pairs_xy_avx2;
+#endif
+    return isa_select(isa_detect(), order_pairs_xy_base, pairs_xy_fn(0), avx2, avx2);
+}
+template <int N>
+inline groups_fn pick_groups() {
+    groups_fn avx2 = 0;
+#if defined(ISA_X86_VARIANTS)
+    avx2 = sort_groups_avx2<N>;
+#endif
+    return isa_select(isa_detect(), sort_groups_base<N>, groups_fn(0), avx2, avx2);
+}
+
+} // namespace pair_order_detail
+
+// int32 רõ汾״εʱѡʵ֣
+inline void order_pairs(int32_t* a, int32_t* b, std::size_t n) {
+    static const pair_order_detail::pairs_fn fn = pair_order_detail::pick_pairs();
+    fn(a, b, n);
+}
+
+// xy δ n  (x, y)ÿ x <= y
+inline void order_pairs_interleaved(int32_t* xy, std::size_t n) {
+    static const pair_order_detail::pairs_xy_fn fn = pair_order_detail::pick_pairs_xy();
+    fn(xy, n);
+}
+
+// data  groups 顢ÿ N  int32
+template <int N>
+inline void sort_groups(int32_t* data, std::size_t groups) {
+    static const pair_order_detail::groups_fn fn = pair_order_detail::pick_groups<N>();
+    fn(data, groups);
+}
+
+// ͵С
+template <int N, class T>
+inline void sort_groups(T* data, std::size_t groups) {
+    for (std::size_t g = 0; g < groups; g++) network_sort<N>(data + g * N);
+}
+
+#endif
@@ -0,0 +1,117 @@
+/*
+  Уͷļһַ飬ԤźúɸԤ AI ǰհ
+    - pcg32ÿһPCG-XSH-RR״̬ 16 ֽڣ
+    - PIECE_CLASSICÿζȵһ֣ԭ rand() % n ķֲͬ
+    - PIECE_BAG7-bagϴһηϴһ 2n ÿһ
+    - PieceQueue̶Ļλ壬ʼձ lookahead ɵķ飻peek/pop  O(1)
+   0..kinds-1 ıűʾ״ɵ߲
+  ͬͬʱȫͬڻطźģ⡣
+*/
+#ifndef PIECE_QUEUE_H
+#define PIECE_QUEUE_H
+
+#include <cstdint>
+
+// PCG32O'Neill, pcg-random.org64 λ LCG ״̬ + û
+struct pcg32 {
+    uint64_t state, inc;
+
+    explicit pcg32(uint64_t seed = 0x853C49E6748FEA9Bull, uint64_t seq = 0xDA3E39CB94B95BDBull) { seed_with(seed, seq); }
+
+    void seed_with(uint64_t seed, uint64_t seq = 0xDA3E39CB94B95BDBull) {
+        state = 0;
+        inc = (seq << 1) | 1;
+        next();
+        state += seed;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ull + inc;
+        uint32_t xs = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xs >> rot) | (xs << ((32 - rot) & 31));
+    }
+
+    // [0, n) ھȷֲȡģƫLemire ĳ˷ܾ
+    uint32_t below(uint32_t n) {
+        uint64_t m = static_cast<uint64_t>(next()) * n;
+        uint32_t lo = static_cast<uint32_t>(m);
+        if (lo < n) {
+            uint32_t t = (0u - n) % n;
+            while (lo < t) {
+                m = static_cast<uint64_t>(next()) * n;
+                lo = static_cast<uint32_t>(m);
+            }
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+};
+
+enum piece_policy {
+    PIECE_CLASSIC,
+    PIECE_BAG
+};
+
+class PieceQueue {
+public:
+    enum { CAPACITY = 64, MAX_KINDS = 16 };     // λ2 ݣķ
+
+    PieceQueue() { reset(1, PIECE_CLASSIC, 0, 1); }
+    PieceQueue(int kinds, piece_policy policy, uint64_t seed, unsigned lookahead = 5) { reset(kinds, policy, seed, lookahead); }
+
+    // ¿ʼһ֣նУǰ lookahead 
+    void reset(int kinds, piece_policy policy, uint64_t seed, unsigned lookahead = 5) {
+        kinds_ = kinds < 1 ? 1 : kinds > MAX_KINDS ? MAX_KINDS : kinds;
+        policy_ = policy;
+        ahead_ = lookahead < 1 ? 1u : lookahead > unsigned(CAPACITY) ? unsigned(CAPACITY) : lookahead;
+        rng_.seed_with(seed);
+        head_ = 0;
+        bag_left_ = 0;
+        for (unsigned i = 0; i < ahead_; i++) ring_[i] = static_cast<uint8_t>(generate());
+    }
+
+    // ֮ k 飨k=0 һk < lookahead()
+    int peek(unsigned k = 0) const { return ring_[(head_ + k) & (CAPACITY - 1)]; }
+
+    // ȡһ飬ڶβһµ
+    int pop() {
+        int p = ring_[head_];
+        ring_[(head_ + ahead_) & (CAPACITY - 1)] = static_cast<uint8_t>(generate());
+        head_ = (head_ + 1) & (CAPACITY - 1);
+        return p;
+    }
+
+    unsigned lookahead() const { return ahead_; }
+    int kinds() const { return kinds_; }
+    piece_policy policy() const { return policy_; }
+
+private:
+    int generate() {
+        if (policy_ == PIECE_CLASSIC) return static_cast<int>(rng_.below(static_cast<uint32_t>(kinds_)));
+        if (!bag_left_) {
+            // Fisher-Yates ϴһ
+            for (int i = 0; i < kinds_; i++) bag_[i] = static_cast<uint8_t>(i);
+            for (int i = kinds_ - 1; i > 0; i--) {
+                int j = static_cast<int>(rng_.below(static_cast<uint32_t>(i + 1)));
+                uint8_t t = bag_[i];
+                bag_[i] = bag_[j];
+                bag_[j] = t;
+            }
+            bag_left_ = kinds_;
+        }
+        return bag_[--bag_left_];
+    }
+
+    pcg32        rng_;
+    int          kinds_;
+    piece_policy policy_;
+    unsigned     ahead_;
+    unsigned     head_;
+    int          bag_left_;
+    uint8_t      bag_[MAX_KINDS];
+    uint8_t      ring_[CAPACITY];
+};
+
+#endif
@@ -0,0 +1,248 @@
+/*
+  εľ̬ռͷļ R 
+    - build һװ룺STRSort-Tile-Recursiveÿ FANOUT һԵϴ
+      нڵ㰴ţ갴УSoA棬ûָҲûпղ
+    - query_point / query_overlap㡢ཻ߽Ҳ㣩
+    - knnĳ k ΣεŷϾ룬ھʱΪ 0
+    - batch_overlap / batch_point߳ѯ CSR ʽ
+  ֻ֮Ա߳ͬʱѯݱ仯ʱ build
+*/
+#ifndef RECT_INDEX_H
+#define RECT_INDEX_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <thread>
+#include <vector>
+
+struct box {
+    double x0, y0, x1, y1;                      // x0 <= x1, y0 <= y1
+};
+
+inline bool box_contains(const box& b, double x, double y) {
+    return b.x0 <= x && x <= b.x1 && b.y0 <= y && y <= b.y1;
+}
+
+inline bool box_overlap(const box& a, const box& b) {
+    return a.x0 <= b.x1 && b.x0 <= a.x1 && a.y0 <= b.y1 && b.y0 <= a.y1;
+}
+
+// 㵽ξƽھΪ 0
+inline double box_dist2(const box& b, double x, double y) {
+    double dx = x < b.x0 ? b.x0 - x : (x > b.x1 ? x - b.x1 : 0.0);
+    double dy = y < b.y0 ? b.y0 - y : (y > b.y1 ? y - b.y1 : 0.0);
+    return dx * dx + dy * dy;
+}
+
+class PackedRTree {
+public:
+    static const int FANOUT = 16;               // ÿڵһڵһ 128 ֽ
+
+    PackedRTree() : n_(0) {}
+
+    size_t size() const { return n_; }
+
+    // װ룻εıž r е±
+    void build(const box* r, size_t n) {
+        n_ = n;
+        x0_.clear(); y0_.clear(); x1_.clear(); y1_.clear();
+        off_.clear();
+        ids_.resize(n);
+        if (!n) return;
+
+        // STRȰ x гԼ sqrt(Ҷ) ٰ y 
+        for (size_t i = 0; i < n; i++) ids_[i] = static_cast<uint32_t>(i);
+        std::sort(ids_.begin(), ids_.end(), [r](uint32_t a, uint32_t b) {
+            return r[a].x0 + r[a].x1 < r[b].x0 + r[b].x1;
+        });
+        size_t leaves = (n + FANOUT - 1) / FANOUT;
+        size_t strips = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(leaves))));
+        size_t per = strips * FANOUT;
+        for (size_t s = 0; s < n; s += per) {
+            std::sort(ids_.begin() + s, ids_.begin() + std::min(s + per, n), [r](uint32_t a, uint32_t b) {
+                return r[a].y0 + r[a].y1 < r[b].y0 + r[b].y1;
+            });
+        }
+
+        size_t total = n, cnt = n;
+        while (cnt > 1) {
+            cnt = (cnt + FANOUT - 1) / FANOUT;
+            total += cnt;
+        }
+        x0_.resize(total); y0_.resize(total); x1_.resize(total); y1_.resize(total);
+        for (size_t i = 0; i < n; i++) {
+            const box& b = r[ids_[i]];
+            x0_[i] = b.x0; y0_[i] = b.y0; x1_[i] = b.x1; y1_[i] = b.y1;
+        }
+
+        // ϣ L  j ڵ㸲ǵ L-1  [j*FANOUT, (j+1)*FANOUT)
+        off_.push_back(0);
+        size_t start = 0;
+        cnt = n;
+        while (cnt > 1) {
+            size_t parents = (cnt + FANOUT - 1) / FANOUT;
+            size_t base = start + cnt;
+            for (size_t p = 0; p < parents; p++) {
+                size_t c0 = start + p * FANOUT, c1 = std::min(c0 + FANOUT, start + cnt);
+                double a0 = x0_[c0], b0 = y0_[c0], a1 = x1_[c0], b1 = y1_[c0];
+                for (size_t c = c0 + 1; c < c1; c++) {
+                    a0 = std::min(a0, x0_[c]); b0 = std::min(b0, y0_[c]);
+                    a1 = std::max(a1, x1_[c]); b1 = std::max(b1, y1_[c]);
+                }
+                x0_[base + p] = a0; y0_[base + p] = b0; x1_[base + p] = a1; y1_[base + p] = b1;
+            }
+            start = base;
+            off_.push_back(start);
+            cnt = parents;
+        }
+        off_.push_back(start + 1);
+    }
+
+    void build(const std::vector<box>& r) { build(r.data(), r.size()); }
+
+    //  q ཻÿεһ fn(uint32_t id)˳򲻶
+    template <class F>
+    void query_overlap(const box& q, F&& fn) const {
+        if (!n_) return;
+        int top = levels() - 1;
+        size_t root = off_[top];
+        if (!overlaps(root, q)) return;
+        if (top == 0) { fn(ids_[0]); return; }
+
+        // Ȳ 16 㣬ÿѹ FANOUT 
+        uint32_t stack[16 * FANOUT];
+        uint8_t  level[16 * FANOUT];
+        int sp = 0;
+        stack[sp] = 0; level[sp] = static_cast<uint8_t>(top); sp++;
+        while (sp) {
+            sp--;
+            int l = level[sp];
+            size_t j = stack[sp];
+            size_t cbase = off_[l - 1];
+            size_t c0 = j * FANOUT, c1 = std::min(c0 + FANOUT, count(l - 1));
+            if (l == 1) {
+                for (size_t c = c0; c < c1; c++)
+                    if (overlaps(cbase + c, q)) fn(ids_[c]);
+            } else {
+                for (size_t c = c0; c < c1; c++)
+                    if (overlaps(cbase + c, q)) {
+                        stack[sp] = static_cast<uint32_t>(c);
+                        level[sp] = static_cast<uint8_t>(l - 1);
+                        sp++;
+                    }
+            }
+        }
+    }
+
+    void query_overlap(const box& q, std::vector<uint32_t>& out) const {
+        query_overlap(q, [&out](uint32_t id) { out.push_back(id); });
+    }
+
+    //  (x, y) ľ
+    template <class F>
+    void query_point(double x, double y, F&& fn) const {
+        box q = { x, y, x, y };
+        query_overlap(q, fn);
+    }
+
+    void query_point(double x, double y, std::vector<uint32_t>& out) const {
+        box q = { x, y, x, y };
+        query_overlap(q, out);
+    }
+
+    //  (x, y)  k ΣӽԶд outգ
+    // ڵΧеľ롱Ҷһʣġ
+    void knn(double x, double y, size_t k, std::vector<uint32_t>& out) const {
+        out.clear();
+        if (!n_ || !k) return;
+        struct item {
+            double   d2;
+            uint32_t idx;
+            int      level;
+            bool operator<(const item& o) const { return d2 > o.d2; }
+        };
+        std::priority_queue<item> pq;
+        int top = levels() - 1;
+        item root = { dist2(off_[top], x, y), 0, top };
+        pq.push(root);
+        while (!pq.empty() && out.size() < k) {
+            item it = pq.top();
+            pq.pop();
+            if (it.level == 0) {
+                out.push_back(ids_[it.idx]);
+                continue;
+            }
+            size_t cbase = off_[it.level - 1];
+            size_t c0 = static_cast<size_t>(it.idx) * FANOUT, c1 = std::min(c0 + FANOUT, count(it.level - 1));
+            for (size_t c = c0; c < c1; c++) {
+                item ch = { dist2(cbase + c, x, y), static_cast<uint32_t>(c), it.level - 1 };
+                pq.push(ch);
+            }
+        }
+    }
+
+    // ཻѯ i ѯĽ hits[offs[i] .. offs[i+1])threads Ϊ 0 ʱȡӲ߳
+    void batch_overlap(const box* q, size_t nq, std::vector<uint32_t>& offs, std::vector<uint32_t>& hits,
+                       unsigned threads = 0) const {
+        if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+        if (nq < 1024) threads = 1;
+        std::vector<std::vector<uint32_t> > part_offs(threads), part_hits(threads);
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; t++) {
+            size_t b = nq * t / threads, e = nq * (t + 1) / threads;
+            auto work = [&, t, b, e] {
+                std::vector<uint32_t>& po = part_offs[t];
+                std::vector<uint32_t>& ph = part_hits[t];
+                po.reserve(e - b);
+                for (size_t i = b; i < e; i++) {
+                    query_overlap(q[i], ph);
+                    po.push_back(static_cast<uint32_t>(ph.size()));
+                }
+            };
+            if (threads == 1) work();
+            else pool.emplace_back(work);
+        }
+        for (std::thread& th : pool) th.join();
+
+        offs.assign(1, 0);
+        offs.reserve(nq + 1);
+        hits.clear();
+        for (unsigned t = 0; t < threads; t++) {
+            uint32_t base = static_cast<uint32_t>(hits.size());
+            for (uint32_t o : part_offs[t]) offs.push_back(base + o);
+            hits.insert(hits.end(), part_hits[t].begin(), part_hits[t].end());
+        }
+    }
+
+    // ѯxy δ np  (x, y)
+    void batch_point(const double* xy, size_t np, std::vector<uint32_t>& offs, std::vector<uint32_t>& hits,
+                     unsigned threads = 0) const {
+        std::vector<box> q(np);
+        for (size_t i = 0; i < np; i++) {
+            box b = { xy[2 * i], xy[2 * i + 1], xy[2 * i], xy[2 * i + 1] };
+            q[i] = b;
+        }
+        batch_overlap(q.data(), np, offs, hits, threads);
+    }
+
+private:
+    int levels() const { return static_cast<int>(off_.size()) - 1; }
+    size_t count(int l) const { return off_[l + 1] - off_[l]; }
+    bool overlaps(size_t i, const box& q) const {
+        return x0_[i] <= q.x1 && q.x0 <= x1_[i] && y0_[i] <= q.y1 && q.y0 <= y1_[i];
+    }
+    double dist2(size_t i, double x, double y) const {
+        box b = { x0_[i], y0_[i], x1_[i], y1_[i] };
+        return box_dist2(b, x, y);
+    }
+
+    size_t                n_;
+    std::vector<double>   x0_, y0_, x1_, y1_;   // ڵİΧУ 0 ǾαSTR ˳
+    std::vector<size_t>   off_;                 //  L Ϊ off_[L]һ
+    std::vector<uint32_t> ids_;                 //  0  i Ӧԭʼ
+};
+
+#endif
@@ -0,0 +1,292 @@
+/*
+  ڴ棨ͷļ pair_order.h ıȽϽ֮
+    - small_sort16 磬ٴһЩò
+    - merge_sortȶȰг 16 һźã磬int32 ʱ 8 һ AVX2
+                  ò֤ȶԵ޷֧鲢Ҫ n Ԫصĸ
+    - radix_sort / radix_sort_byԭ MSD American flag sort
+                  ÿΰһֽڷͰͰڽλҪ
+    - parallel_sort߳ԼһΣٰ merge path ÿֹ鲢ָ߳
+   radix_sortҪȶ˳ԶȽʱ merge_sort / parallel_sort
+*/
+#ifndef SORT_ENGINE_H
+#define SORT_ENGINE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "pair_order.h"
+
+// ڳȵn  0..16
+template <class T, class Less>
+inline void network_sort_n(T* v, std::size_t n, Less less) {
+    switch (n) {
+    case 2:  network_sort<2>(v, less);  break;
+    case 3:  network_sort<3>(v, less);  break;
+    case 4:  network_sort<4>(v, less);  break;
+    case 5:  network_sort<5>(v, less);  break;
+    case 6:  network_sort<6>(v, less);  break;
+    case 7:  network_sort<7>(v, less);  break;
+    case 8:  network_sort<8>(v, less);  break;
+    case 9:  network_sort<9>(v, less);  break;
+    case 10: network_sort<10>(v, less); break;
+    case 11: network_sort<11>(v, less); break;
+    case 12: network_sort<12>(v, less); break;
+    case 13: network_sort<13>(v, less); break;
+    case 14: network_sort<14>(v, less); break;
+    case 15: network_sort<15>(v, less); break;
+    case 16: network_sort<16>(v, less); break;
+    default: break;
+    }
+}
+
+// ȶĲС
+template <class T, class Less>
+inline void insertion_sort(T* v, std::size_t n, Less less) {
+    for (std::size_t i = 1; i < n; i++) {
+        T x = v[i];
+        std::size_t j = i;
+        for (; j > 0 && less(x, v[j - 1]); j--) v[j] = v[j - 1];
+        v[j] = x;
+    }
+}
+
+// С򣨲ȶ16 磬
+template <class T, class Less>
+inline void small_sort(T* v, std::size_t n, Less less) {
+    if (n <= 16) network_sort_n(v, n, less);
+    else insertion_sort(v, n, less);
+}
+
+namespace sort_engine_detail {
+
+const std::size_t RUN = 16;                     // źõĳʼγ
+const std::size_t PARALLEL_MIN = 1 << 16;       // СȲֵÿ߳
+const std::size_t RADIX_SMALL = 64;             // СȵͰò
+
+// Ͱ < ȽʱԪ޴֣Ĳȶɼ뱣ȶ
+template <class T, class Less>
+struct plain_order
+    : std::integral_constant<bool, std::is_arithmetic<T>::value && std::is_same<Less, std::less<T> >::value> {};
+
+//  v г RUN һηֱĩβһεĲֵ
+template <class T, class Less>
+inline void sort_runs(T* v, std::size_t n, Less less) {
+    std::size_t g = n / RUN;
+    for (std::size_t i = 0; i < g; i++) {
+        if (plain_order<T, Less>::value) network_sort<RUN>(v + i * RUN, less);
+        else insertion_sort(v + i * RUN, RUN, less);
+    }
+    insertion_sort(v + g * RUN, n - g * RUN, less);
+}
+
+inline void sort_runs(int32_t* v, std::size_t n, std::less<int32_t> less) {
+    std::size_t g = n / RUN;
+    sort_groups<RUN>(v, g);
+    insertion_sort(v + g * RUN, n - g * RUN, less);
+}
+
+// ޷֧鲢ÿдһԪأֻȽϽƶαꣻʱȡ aȶ
+template <class T, class Less>
+inline void merge_into(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, Less less) {
+    const T* ea = a + na;
+    const T* eb = b + nb;
+    while (a < ea && b < eb) {
+        bool tb = less(*b, *a);
+        *out++ = tb ? *b : *a;
+        b += tb;
+        a += !tb;
+    }
+    while (a < ea) *out++ = *a++;
+    while (b < eb) *out++ = *b++;
+}
+
+// merge pathϲǰ k жٸ a
+template <class T, class Less>
+inline std::size_t co_rank(std::size_t k, const T* a, std::size_t na, const T* b, std::size_t nb, Less less) {
+    std::size_t lo = k > nb ? k - nb : 0;
+    std::size_t hi = k < na ? k : na;
+    while (lo < hi) {
+        std::size_t i = lo + (hi - lo) / 2;
+        if (less(b[k - i - 1], a[i])) hi = i;
+        else lo = i + 1;
+    }
+    return lo;
+}
+
+//  [a, a+na)  [b, b+nb) ϲд out  [from, to) 
+template <class T, class Less>
+inline void merge_range(const T* a, std::size_t na, const T* b, std::size_t nb, T* out,
+                        std::size_t from, std::size_t to, Less less) {
+    std::size_t i0 = co_rank(from, a, na, b, nb, less);
+    std::size_t i1 = co_rank(to, a, na, b, nb, less);
+    merge_into(a + i0, i1 - i0, b + (from - i0), (to - i1) - (from - i0), out + from, less);
+}
+
+// ԵϹ鲢γ width ʼ v 
+template <class T, class Less>
+inline void merge_passes(T* v, T* buf, std::size_t n, std::size_t width, Less less) {
+    T* src = v;
+    T* dst = buf;
+    for (; width < n; width *= 2) {
+        for (std::size_t lo = 0; lo < n; lo += 2 * width) {
+            std::size_t mid = std::min(lo + width, n);
+            std::size_t hi = std::min(lo + 2 * width, n);
+            merge_into(src + lo, mid - lo, src + mid, hi - mid, dst + lo, less);
+        }
+        std::swap(src, dst);
+    }
+    if (src != v) std::copy(src, src + n, v);
+}
+
+// ֵȥţзתλ޷űȽϣ˳򲻱
+template <class K>
+inline typename std::make_unsigned<K>::type radix_key(K k) {
+    typedef typename std::make_unsigned<K>::type U;
+    return std::is_signed<K>::value ? static_cast<U>(k) ^ (U(1) << (sizeof(K) * 8 - 1)) : static_cast<U>(k);
+}
+
+// American flag sort shift ֽڷ 256 ͰѭԪطŽԵͰ
+template <class T, class Key>
+void flag_sort(T* v, std::size_t n, Key key, int shift) {
+    for (;;) {
+        if (n < RADIX_SMALL) {
+            small_sort(v, n, [&key](const T& x, const T& y) { return key(x) < key(y); });
+            return;
+        }
+        std::size_t cnt[256] = {0};
+        for (std::size_t i = 0; i < n; i++) cnt[static_cast<unsigned>(key(v[i]) >> shift) & 255]++;
+
+        // һֽȫֱͬӿһֽڣðһ齻
+        unsigned only = static_cast<unsigned>(key(v[0]) >> shift) & 255;
+        if (cnt[only] != n) {
+            std::size_t head[256], tail[256], s = 0;
+            for (int d = 0; d < 256; d++) {
+                head[d] = s;
+                s += cnt[d];
+                tail[d] = s;
+            }
+            for (int d = 0; d < 256; d++) {
+                while (head[d] < tail[d]) {
+                    T x = v[head[d]];
+                    unsigned e = static_cast<unsigned>(key(x) >> shift) & 255;
+                    while (e != static_cast<unsigned>(d)) {
+                        std::swap(x, v[head[e]++]);
+                        e = static_cast<unsigned>(key(x) >> shift) & 255;
+                    }
+                    v[head[d]++] = x;
+                }
+            }
+            if (shift == 0) return;
+            std::size_t lo = 0;
+            for (int d = 0; d < 256; d++) {
+                if (cnt[d] > 1) flag_sort(v + lo, cnt[d], key, shift - 8);
+                lo += cnt[d];
+            }
+            return;
+        }
+        if (shift == 0) return;
+        shift -= 8;
+    }
+}
+
+} // namespace sort_engine_detail
+
+// ȶ鲢buf  n Ԫأ 0 ʱڲ
+template <class T, class Less>
+void merge_sort(T* v, std::size_t n, Less less, T* buf = 0) {
+    using namespace sort_engine_detail;
+    if (n <= RUN) {
+        insertion_sort(v, n, less);
+        return;
+    }
+    std::vector<T> own;
+    if (!buf) {
+        own.resize(n);
+        buf = own.data();
+    }
+    sort_runs(v, n, less);
+    merge_passes(v, buf, n, RUN, less);
+}
+
+template <class T>
+void merge_sort(T* v, std::size_t n) {
+    merge_sort(v, n, std::less<T>());
+}
+
+// ޷ԭkey(x)  uint8/16/32/64_t
+template <class T, class Key>
+void radix_sort_by(T* v, std::size_t n, Key key) {
+    typedef decltype(key(*v)) U;
+    if (n > 1) sort_engine_detail::flag_sort(v, n, key, static_cast<int>(sizeof(U) * 8 - 8));
+}
+
+// ԭзš޷žɣ
+template <class K>
+void radix_sort(K* v, std::size_t n) {
+    radix_sort_by(v, n, [](K k) { return sort_engine_detail::radix_key(k); });
+}
+
+// ߳ȶthreads Ϊ 0 ʱȡӲ߳
+template <class T, class Less>
+void parallel_sort(T* v, std::size_t n, unsigned threads, Less less) {
+    using namespace sort_engine_detail;
+    if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads == 1 || n < PARALLEL_MIN) {
+        merge_sort(v, n, less);
+        return;
+    }
+    std::vector<T> own(n);
+    T* buf = own.data();
+
+    // һг threads ΣÿԼ߳ź
+    std::vector<std::size_t> cut(threads + 1);
+    for (unsigned t = 0; t <= threads; t++) cut[t] = n * t / threads;
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++)
+        pool.emplace_back([&, t] { merge_sort(v + cut[t], cut[t + 1] - cut[t], less, buf + cut[t]); });
+    for (std::thread& th : pool) th.join();
+
+    // ֮ÿ鲢ÿԵ merge path гƬ̶֤߳л
+    T* src = v;
+    T* dst = buf;
+    while (cut.size() > 2) {
+        std::size_t pairs = (cut.size() - 1) / 2;
+        unsigned per = std::max(1u, static_cast<unsigned>(threads / pairs));
+        std::vector<std::size_t> next;
+        pool.clear();
+        for (std::size_t p = 0; p < pairs; p++) {
+            std::size_t lo = cut[2 * p], mid = cut[2 * p + 1], hi = cut[2 * p + 2];
+            next.push_back(lo);
+            for (unsigned s = 0; s < per; s++) {
+                std::size_t from = (hi - lo) * s / per, to = (hi - lo) * (s + 1) / per;
+                pool.emplace_back([=] {
+                    merge_range(src + lo, mid - lo, src + mid, hi - mid, dst + lo, from, to, less);
+                });
+            }
+        }
+        if ((cut.size() - 1) % 2) {
+            // 䵥һԭȥ
+            std::size_t lo = cut[cut.size() - 2], hi = cut.back();
+            next.push_back(lo);
+            std::copy(src + lo, src + hi, dst + lo);
+        }
+        next.push_back(n);
+        for (std::thread& th : pool) th.join();
+        cut.swap(next);
+        std::swap(src, dst);
+    }
+    if (src != v) std::copy(src, src + n, v);
+}
+
+template <class T>
+void parallel_sort(T* v, std::size_t n, unsigned threads = 0) {
+    parallel_sort(v, n, threads, std::less<T>());
+}
+
+#endif
@@ -0,0 +1,202 @@
+/*
+  ն˺ˣͷļͬһӿڣWindows ÿ̨ APIϵͳ termios + ANSI
+    - term_init / term_restore/˳Ϸģʽԭʼ롢ԡعꣻWindows  VT вѶʱȵ 1ms
+    - term_poll_keysȡسESCذλ
+    - term_now_ms / term_sleep_msʱ˯ߣGetTickCount/Sleep  clock_gettime/nanosleep
+    - term_beepterm_clearterm_cursorʾ/ع
+  궨λͳһ ANSI У\033[;Hɵͬһд
+  Windows  GetAsyncKeyState ӳ˿̰šնֻյ¼סʱն˵Զظ
+   POSIX 汾صǡϴβѯļ֡ѯϷЧͬ
+*/
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#  include <mmsystem.h>
+#  if defined(_MSC_VER)
+#    pragma comment(lib, "winmm.lib")
+#  endif
+#else
+#  include <csignal>
+#  include <ctime>
+#  include <termios.h>
+#  include <unistd.h>
+#endif
+
+enum term_key {
+    KEY_UP    = 1 << 0,
+    KEY_DOWN  = 1 << 1,
+    KEY_LEFT  = 1 << 2,
+    KEY_RIGHT = 1 << 3,
+    KEY_ENTER = 1 << 4,
+    KEY_ESC   = 1 << 5
+};
+
+namespace term_detail {
+
+inline void put(const char* s, size_t n) {
+    std::fwrite(s, 1, n, stdout);
+    std::fflush(stdout);
+}
+
+#if !defined(_WIN32)
+struct state {
+    bool           active;
+    bool           raw;
+    struct termios saved;
+};
+inline state& st() {
+    static state s = { false, false, termios() };
+    return s;
+}
+inline void on_signal(int sig);
+#endif
+
+} // namespace term_detail
+
+inline void term_cursor(bool visible) {
+    term_detail::put(visible ? "\033[?25h" : "\033[?25l", 6);
+}
+
+// صϽ
+inline void term_clear() {
+    term_detail::put("\033[2J\033[H", 7);
+}
+
+// ָǰն״̬ظ
+inline void term_restore() {
+#if defined(_WIN32)
+    static bool done = false;
+    if (done) return;
+    done = true;
+    timeEndPeriod(1);
+#else
+    term_detail::state& s = term_detail::st();
+    if (!s.active) return;
+    s.active = false;
+    if (s.raw) tcsetattr(STDIN_FILENO, TCSANOW, &s.saved);
+#endif
+    term_cursor(true);
+}
+
+// raw_input ΪʱرлԣɶϷãΪʱֻص׼
+inline void term_init(bool raw_input = true) {
+#if defined(_WIN32)
+    HANDLE h = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(h, &mode))
+        SetConsoleMode(h, mode | 0x0004);       // ENABLE_VIRTUAL_TERMINAL_PROCESSING
+    timeBeginPeriod(1);
+    (void)raw_input;
+#else
+    term_detail::state& s = term_detail::st();
+    if (s.active) return;
+    s.active = true;
+    s.raw = false;
+    if (raw_input && isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &s.saved) == 0) {
+        struct termios t = s.saved;
+        t.c_lflag &= ~(ICANON | ECHO);
+        t.c_cc[VMIN] = 0;                       // read ȴûʱ 0
+        t.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &t);
+        s.raw = true;
+    }
+    // ˳ Ctrl+C ʱն˻ԭ
+    std::atexit(term_restore);
+    std::signal(SIGINT, term_detail::on_signal);
+    std::signal(SIGTERM, term_detail::on_signal);
+#endif
+}
+
+#if !defined(_WIN32)
+// źſܴ fwrite ֻ̣߳첽źŰȫ tcsetattr  write stdio
+// ûдĻһ𶪵atexit  term_restore ִ
+inline void term_detail::on_signal(int sig) {
+    state& s = st();
+    if (s.active) {
+        if (s.raw) tcsetattr(STDIN_FILENO, TCSANOW, &s.saved);
+        ssize_t n = write(STDOUT_FILENO, "\033[?25h", 6);
+        (void)n;
+    }
+    std::signal(sig, SIG_DFL);
+    std::raise(sig);
+}
+#endif
+
+// ǰ£ϴβѯļterm_key 
+inline unsigned term_poll_keys() {
+    unsigned k = 0;
+#if defined(_WIN32)
+    if (GetAsyncKeyState(VK_UP))     k |= KEY_UP;
+    if (GetAsyncKeyState(VK_DOWN))   k |= KEY_DOWN;
+    if (GetAsyncKeyState(VK_LEFT))   k |= KEY_LEFT;
+    if (GetAsyncKeyState(VK_RIGHT))  k |= KEY_RIGHT;
+    if (GetAsyncKeyState(VK_RETURN)) k |= KEY_ENTER;
+    if (GetAsyncKeyState(VK_ESCAPE)) k |= KEY_ESC;
+#else
+    unsigned char b[64];
+    ssize_t n;
+    while ((n = read(STDIN_FILENO, b, sizeof(b))) > 0) {
+        for (ssize_t i = 0; i < n; i++) {
+            if (b[i] == 0x1B && i + 2 < n && (b[i + 1] == '[' || b[i + 1] == 'O')) {
+                switch (b[i + 2]) {
+                case 'A': k |= KEY_UP;    break;
+                case 'B': k |= KEY_DOWN;  break;
+                case 'C': k |= KEY_RIGHT; break;
+                case 'D': k |= KEY_LEFT;  break;
+                default: break;
+                }
+                i += 2;
+            } else if (b[i] == 0x1B) {
+                k |= KEY_ESC;                   //  ESCûиУ
+            } else if (b[i] == '\n' || b[i] == '\r') {
+                k |= KEY_ENTER;
+            }
+        }
+    }
+#endif
+    return k;
+}
+
+// ʱӣ
+inline uint64_t term_now_ms() {
+#if defined(_WIN32)
+    return GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000u + static_cast<uint64_t>(ts.tv_nsec) / 1000000u;
+#endif
+}
+
+inline void term_sleep_ms(unsigned ms) {
+#if defined(_WIN32)
+    Sleep(ms);
+#else
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = static_cast<long>(ms % 1000) * 1000000L;
+    while (nanosleep(&ts, &ts) != 0) {}         // źŴʱ˯ʣಿ
+#endif
+}
+
+// նַֻܷƵʱն˾
+inline void term_beep(unsigned freq, unsigned ms) {
+#if defined(_WIN32)
+    Beep(freq, ms);
+#else
+    (void)freq;
+    (void)ms;
+    term_detail::put("\a", 1);
+#endif
+}
+
+#endif
@@ -0,0 +1,524 @@
+/*
+  ˹ AIͷļԵǰԤеĺѡǰ
+    - bot_boardÿһ 16 λ루 10 λΪУ̵ Zobrist ϣʱ
+    - йϷͬкÿʣµĸ䵽ײ
+    - ܸ߶ȡնи߶ȲϣYiyuan Lee Ȩأ
+    - value(, ʣ෽) = ʣһȡ е÷ +  value ֵ
+    - ûtransposition.h˳̶ͬ߷ͬһ (, ʣ) ֻ
+      ͬʱߵ㣬к;ͬ飬ټ
+      ǰհÿһʣ֮ı䣬һĽҲòϡֻڻʣ BOT_TT_MIN_LEFT 
+      ϷľҶӺֻʣһľ治飨һδеĻȱʧֱ㻹
+      ʵ bag  34 չ 0.5%ʡµľԼ 0.05%뿪֮ڣ
+      tt_bytes Ϊ 0 ʱȫû
+    - threads > 1 ʱڵָ̣߳ͬһû̷ֿ߳ǣ뵥߳ȫͬ
+  㣨ÿַĸԤұ߽硢ÿ͸͸λϵ룬 bot_piece
+    - ڵ㣺bot_reach ӷ鵱ǰλðϷĲҡһԭת BFS
+      ƽơմֱ䵽˵λãҲų˱ס߲
+    - 飺for_each_drop е߸ͷ͸һгеֱУ
+      ״ͬĳO  4 I/S/Z  2 ֻϵǸŶҲ©
+*/
+#ifndef TETRIS_BOT_H
+#define TETRIS_BOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "transposition.h"
+
+enum { BOT_W = 10, BOT_H = 20, BOT_MAX_PLY = 8, BOT_MAX_KINDS = 16 };
+
+const uint16_t BOT_FULL = (1u << BOT_W) - 1;
+
+// һַĸ򣬼Ԥõıx ΪϽУȡ -3..BOT_W-1
+struct bot_piece {
+    int      len;
+    uint8_t  rows[4][4];                // rows[ro][i] ĵ j λ mask[ro][i][j]
+    int8_t   left[4], right[4];         // иӵУϽǣ
+    int8_t   lo[4], hi[4];              // иӵϡ
+    int8_t   bottom[4][4];              // ÿһкţΪ -1
+    int8_t   canon[4], dx[4], dy[4];    // ״볯 canon ͬ(ro, x, y)  (canon, x+dx, y+dy)dy >= 0
+    uint16_t cells[4][BOT_W + 3][4];    // Ͻڵ x ʱе룬± x+3 x Ϊ 0
+
+    bool in_range(int ro, int x) const { return x + left[ro] >= 0 && x + right[ro] < BOT_W; }
+};
+
+//  lenlen ĳ
+inline bot_piece bot_piece_from_mask(int len, const bool mask[4][4][4]) {
+    bot_piece p;
+    memset(&p, 0, sizeof(p));
+    p.len = len;
+    for (int ro = 0; ro < 4; ro++) {
+        p.left[ro] = 4;
+        p.right[ro] = -1;
+        p.lo[ro] = 4;
+        p.hi[ro] = -1;
+        for (int j = 0; j < 4; j++) p.bottom[ro][j] = -1;
+        for (int i = 0; i < len; i++)
+            for (int j = 0; j < len; j++)
+                if (mask[ro][i][j]) {
+                    p.rows[ro][i] |= static_cast<uint8_t>(1u << j);
+                    if (j < p.left[ro]) p.left[ro] = static_cast<int8_t>(j);
+                    if (j > p.right[ro]) p.right[ro] = static_cast<int8_t>(j);
+                    if (i < p.lo[ro]) p.lo[ro] = static_cast<int8_t>(i);
+                    p.hi[ro] = static_cast<int8_t>(i);
+                    p.bottom[ro][j] = static_cast<int8_t>(i);
+                }
+        for (int x = -3; x < BOT_W; x++)
+            if (p.in_range(ro, x))
+                for (int i = 0; i < 4; i++)
+                    p.cells[ro][x + 3][i] = static_cast<uint16_t>(x >= 0 ? p.rows[ro][i] << x : p.rows[ro][i] >> -x);
+    }
+    // ƵϽǺ״ͬĳΪһ࣬Ըϣlo СĳΪ
+    // ͬһôʾʱ y Ŷ㲻Ϊ y < 0 ©lo ͬȡС
+    for (int ro = 0; ro < 4; ro++) {
+        p.canon[ro] = static_cast<int8_t>(ro);
+        for (int r = 0; r < 4; r++) {
+            bool same = p.hi[r] - p.lo[r] == p.hi[ro] - p.lo[ro];
+            for (int i = 0; same && i <= p.hi[ro] - p.lo[ro]; i++)
+                same = (p.rows[ro][p.lo[ro] + i] >> p.left[ro]) == (p.rows[r][p.lo[r] + i] >> p.left[r]);
+            int c = p.canon[ro];
+            if (same && (p.lo[r] < p.lo[c] || (p.lo[r] == p.lo[c] && r < c))) p.canon[ro] = static_cast<int8_t>(r);
+        }
+        p.dx[ro] = static_cast<int8_t>(p.left[ro] - p.left[p.canon[ro]]);
+        p.dy[ro] = static_cast<int8_t>(p.lo[ro] - p.lo[p.canon[ro]]);
+    }
+    return p;
+}
+
+// 㣺 roϽ (x, y)Ϸ Block  x, y, nowRotateID ͬ
+struct bot_move {
+    int   ro, x, y;
+    int   lines;
+    float score;
+};
+
+inline uint16_t bot_pack_move(int ro, int x, int y) {
+    return static_cast<uint16_t>(ro | (x + 3) << 2 | y << 6);
+}
+
+// Zobrist ÿһʣе k ǵ p ַٸһ
+struct bot_zobrist {
+    uint64_t cell[BOT_H][BOT_W];
+    uint64_t piece[BOT_MAX_PLY][BOT_MAX_KINDS];
+
+    bot_zobrist() {
+        uint64_t s = 0x2545F4914F6CDD1Dull;
+        for (int i = 0; i < BOT_H; i++)
+            for (int j = 0; j < BOT_W; j++) cell[i][j] = splitmix(s);
+        for (int k = 0; k < BOT_MAX_PLY; k++)
+            for (int p = 0; p < BOT_MAX_KINDS; p++) piece[k][p] = splitmix(s);
+    }
+
+    static const bot_zobrist& get() {
+        static const bot_zobrist z;
+        return z;
+    }
+
+private:
+    static uint64_t splitmix(uint64_t& s) {
+        uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+inline int bot_popcount(unsigned v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(v);
+#else
+    int n = 0;
+    for (; v; v &= v - 1) n++;
+    return n;
+#endif
+}
+
+// λ 1 ڵڼλv 
+inline int bot_ctz(unsigned v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(v);
+#else
+    int n = 0;
+    while (!(v & 1)) {
+        v >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+struct bot_board {
+    uint16_t row[BOT_H];                // row[0] Ϊһ
+    uint64_t hash;
+
+    bot_board() { clear(); }
+
+    void clear() {
+        memset(row, 0, sizeof(row));
+        hash = 0;
+    }
+
+    // Ƿ루ϷǷţ
+    template <class Cell>
+    void load(const Cell (&cells)[BOT_H][BOT_W]) {
+        for (int i = 0; i < BOT_H; i++) {
+            row[i] = 0;
+            for (int j = 0; j < BOT_W; j++)
+                if (cells[i][j]) row[i] |= static_cast<uint16_t>(1u << j);
+        }
+        rehash();
+    }
+
+    void rehash() {
+        const bot_zobrist& z = bot_zobrist::get();
+        hash = 0;
+        for (int i = 0; i < BOT_H; i++)
+            for (unsigned m = row[i]; m; m &= m - 1) hash ^= z.cell[i][bot_ctz(m)];
+    }
+
+    bool fits(const bot_piece& p, int ro, int x, int y) const {
+        if (!p.in_range(ro, x) || y + p.lo[ro] < 0 || y + p.hi[ro] >= BOT_H) return false;
+        const uint16_t* m = p.cells[ro][x + 3];
+        for (int i = p.lo[ro]; i <= p.hi[ro]; i++)
+            if (row[y + i] & m[i]) return false;
+        return true;
+    }
+
+    // һڵУΪ BOT_H
+    void surface(int top[BOT_W]) const {
+        for (int j = 0; j < BOT_W; j++) top[j] = BOT_H;
+        unsigned seen = 0;
+        for (int i = 0; i < BOT_H && seen != BOT_FULL; i++) {
+            for (unsigned m = row[i] & ~seen; m; m &= m - 1) top[bot_ctz(m)] = i;
+            seen |= row[i];
+        }
+    }
+
+    // תãcol[j] ĵ i λ i е j 
+    void columns(uint32_t col[BOT_W]) const {
+        for (int j = 0; j < BOT_W; j++) col[j] = 0;
+        for (int i = 0; i < BOT_H; i++)
+            for (unsigned m = row[i]; m; m &= m - 1) col[bot_ctz(m)] |= 1u << i;
+    }
+
+    // ·鲢ϷУǰ fits()
+    int place(const bot_piece& p, int ro, int x, int y) {
+        const bot_zobrist& z = bot_zobrist::get();
+        int full = 0;
+        for (int i = p.lo[ro]; i <= p.hi[ro]; i++) {
+            uint16_t m = p.cells[ro][x + 3][i];
+            if (!m) continue;
+            row[y + i] |= m;
+            for (unsigned b = m; b; b &= b - 1) hash ^= z.cell[y + i][bot_ctz(b)];
+            full += row[y + i] == BOT_FULL;
+        }
+        if (full) collapse();
+        return full;
+    }
+
+    // Уÿʣµĸ䵽ײͬ CollapseLines
+    void collapse() {
+        int count[BOT_W] = {0};
+        for (int i = 0; i < BOT_H; i++) {
+            if (row[i] == BOT_FULL) continue;
+            for (unsigned m = row[i]; m; m &= m - 1) count[bot_ctz(m)]++;
+        }
+        for (int i = 0; i < BOT_H; i++) {
+            uint16_t m = 0;
+            for (int j = 0; j < BOT_W; j++)
+                if (count[j] >= BOT_H - i) m |= static_cast<uint16_t>(1u << j);
+            row[i] = m;
+        }
+        rehash();
+    }
+};
+
+// ԽԽ
+inline float bot_evaluate(const bot_board& b) {
+    int height[BOT_W] = {0};
+    unsigned seen = 0;
+    int holes = 0;
+    for (int i = 0; i < BOT_H; i++) {
+        unsigned m = b.row[i];
+        for (unsigned top = m & ~seen; top; top &= top - 1) height[bot_ctz(top)] = BOT_H - i;
+        holes += bot_popcount(seen & ~m);
+        seen |= m;
+    }
+    int aggregate = 0, bumpiness = 0;
+    for (int j = 0; j < BOT_W; j++) {
+        aggregate += height[j];
+        if (j) bumpiness += height[j] > height[j - 1] ? height[j] - height[j - 1] : height[j - 1] - height[j];
+    }
+    return -0.510066f * aggregate - 0.35663f * holes - 0.184483f * bumpiness;
+}
+
+// ֱɴ㣬ÿ f(ro, x, y) =  (߸ - 1 - ͸) Сֵ
+// ֻ߸ϣ y=0 ͵Ƕմλò㣨 bot_reach 
+// ֻߴ y ͬ״ĳy < 0 ʱҲŲ
+template <class F>
+inline void bot_for_each_drop(const bot_board& b, const bot_piece& p, F f) {
+    int top[BOT_W];
+    b.surface(top);
+    for (int ro = 0; ro < 4; ro++) {
+        if (p.canon[ro] != ro) continue;
+        const int8_t* bottom = p.bottom[ro];
+        for (int x = -p.left[ro]; x + p.right[ro] < BOT_W; x++) {
+            int y = BOT_H;
+            for (int j = p.left[ro]; j <= p.right[ro]; j++) {
+                int t = top[x + j] - 1 - bottom[j];
+                if (bottom[j] >= 0 && t < y) y = t;
+            }
+            if (y >= 0) f(ro, x, y);
+        }
+    }
+}
+
+enum bot_step { BOT_STEP_LEFT, BOT_STEP_RIGHT, BOT_STEP_DOWN, BOT_STEP_ROTATE, BOT_STEP_STAY };
+
+// ɴԣӸλóϷĲҡһԭ˳ʱתһΣߵ
+//   run()ÿ (, ) һ 32 λʾЩзŵ¡Щѵһչ
+//          üӷλһĿУҺת밴λ룬ɨ輴
+//          ѵһзŲµλãͬһ״ͬһλõĲֻͬһ
+//   first_step() BFS ·ĳĵһAI ʱÿΰǰã
+class bot_reach {
+public:
+    enum { XS = BOT_W + 3, STATES = 4 * XS * BOT_H };
+
+    // ŲʱΪ 0
+    int run(const bot_board& b, const bot_piece& p, int ro, int x, int y) {
+        uint32_t col[BOT_W];                // иӵ
+        b.columns(col);
+        for (int r = 0; r < 4; r++)
+            for (int xi = 0; xi < XS; xi++) {
+                reach_[r][xi] = 0;
+                free_[r][xi] = p.in_range(r, xi - 3) ? free_rows(p, r, xi - 3, col) : 0;
+            }
+        nland_ = 0;
+        if (x < -3 || x >= BOT_W || y < 0 || y >= BOT_H || !(free_[ro][x + 3] >> y & 1)) return 0;
+        reach_[ro][x + 3] = 1u << y;
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (int r = 0; r < 4; r++)
+                for (int xi = 0; xi < XS; xi++) {
+                    uint32_t f = free_[r][xi], s = reach_[r][xi];
+                    if (!s) continue;
+                    s |= ((s + f) ^ f) & f;         // ѵ£ֱŲµ
+                    reach_[r][xi] = s;
+                    if (xi > 0) changed |= spread(s, r, xi - 1);
+                    if (xi + 1 < XS) changed |= spread(s, r, xi + 1);
+                    changed |= spread(s, (r + 1) & 3, xi);
+                }
+        }
+        // Ѽµ㣬ꣻ xy  3 4 ó
+        uint64_t done[4][XS + 8] = {{0}};
+        for (int r = 0; r < 4; r++)
+            for (int xi = 0; xi < XS; xi++) {
+                uint32_t land = reach_[r][xi] & ~(free_[r][xi] >> 1);
+                if (!land) continue;
+                int c = p.canon[r], cx = xi + p.dx[r] + 4, shift = p.dy[r] + 4;
+                uint64_t fresh = (static_cast<uint64_t>(land) << shift) & ~done[c][cx];
+                done[c][cx] |= fresh;
+                for (uint32_t m = static_cast<uint32_t>(fresh >> shift); m; m &= m - 1) {
+                    bot_move mv = {r, xi - 3, bot_ctz(m), 0, 0};
+                    land_[nland_++] = mv;
+                }
+            }
+        return nland_;
+    }
+
+    int count() const { return nland_; }
+    const bot_move& landing(int k) const { return land_[k]; }
+
+    //  from ߵ to ĵһbot_stepĿ귵 BOT_STEP_STAY˷ -1
+    int first_step(const bot_board& b, const bot_piece& p, const bot_move& from, const bot_move& to) {
+        if (!valid(from) || !valid(to) || !b.fits(p, from.ro, from.x, from.y)) return -1;
+        int start = id(from.ro, from.x, from.y), goal = id(to.ro, to.x, to.y);
+        if (start == goal) return BOT_STEP_STAY;
+        memset(seen_, 0, sizeof(seen_));
+        int head = 0, tail = 0;
+        mark(start);
+        queue_[tail++] = static_cast<uint16_t>(start);
+        while (head < tail) {
+            int s = queue_[head++];
+            if (s == goal) {
+                while (parent_[s] != start) s = parent_[s];
+                return how_[s];
+            }
+            int r = s / (XS * BOT_H), cx = s / BOT_H % XS - 3, cy = s % BOT_H;
+            visit(b, p, s, r, cx, cy + 1, BOT_STEP_DOWN, tail);
+            visit(b, p, s, r, cx - 1, cy, BOT_STEP_LEFT, tail);
+            visit(b, p, s, r, cx + 1, cy, BOT_STEP_RIGHT, tail);
+            visit(b, p, s, (r + 1) & 3, cx, cy, BOT_STEP_ROTATE, tail);
+        }
+        return -1;
+    }
+
+private:
+    // Ͻڵ x ʱŵµ yy >= 0Ϸһ£ֻӵ 0 ߣ
+    static uint32_t free_rows(const bot_piece& p, int ro, int x, const uint32_t col[BOT_W]) {
+        uint32_t hit = 0;
+        for (int i = p.lo[ro]; i <= p.hi[ro]; i++) {
+            uint32_t rows = 0;
+            for (unsigned m = p.cells[ro][x + 3][i]; m; m &= m - 1) rows |= col[bot_ctz(m)];
+            hit |= rows >> i;               //  y λ i  y+i ʱײ
+        }
+        return ~hit & ((1u << (BOT_H - p.hi[ro])) - 1);
+    }
+
+    bool spread(uint32_t s, int r, int xi) {
+        uint32_t n = s & free_[r][xi] & ~reach_[r][xi];
+        reach_[r][xi] |= n;
+        return n != 0;
+    }
+
+    static bool valid(const bot_move& m) { return m.ro >= 0 && m.ro < 4 && m.x >= -3 && m.x < BOT_W && m.y >= 0 && m.y < BOT_H; }
+    static int id(int ro, int x, int y) { return (ro * XS + x + 3) * BOT_H + y; }
+    void mark(int s) { seen_[s >> 6] |= 1ull << (s & 63); }
+    bool seen(int s) const { return (seen_[s >> 6] >> (s & 63)) & 1; }
+
+    void visit(const bot_board& b, const bot_piece& p, int from, int ro, int x, int y, int how, int& tail) {
+        if (x < -3 || x >= BOT_W || y >= BOT_H) return;
+        int s = id(ro, x, y);
+        if (seen(s) || !b.fits(p, ro, x, y)) return;
+        mark(s);
+        parent_[s] = static_cast<uint16_t>(from);
+        how_[s] = static_cast<uint8_t>(how);
+        queue_[tail++] = static_cast<uint16_t>(s);
+    }
+
+    uint32_t free_[4][XS], reach_[4][XS];
+    bot_move land_[4 * XS * BOT_H];
+    int      nland_;
+    uint64_t seen_[(STATES + 63) / 64];
+    uint16_t parent_[STATES], queue_[STATES];
+    uint8_t  how_[STATES];
+};
+
+const float BOT_LINE_WEIGHT = 0.760666f;
+const float BOT_DEAD = -1e9f;           // Ųκ㣨ͷ
+const int BOT_TT_MIN_LEFT = 2;           // ٻʣôľŲ顢û
+
+class TetrisBot {
+public:
+    // tt_bytes Ϊ 0 ʱûȲҲǣգ
+    TetrisBot(const std::vector<bot_piece>& pieces, size_t tt_bytes = size_t(16) << 20)
+        : pieces_(pieces), tt_(tt_bytes), use_tt_(tt_bytes != 0), nodes_(0), searches_(0) {}
+
+    //  b η seq[0..n-1]ǰԤ seq[0] 㣻
+    // ǰ fromxyڴߵõλá
+    // ûκοɷŵλʱ score Ϊ BOT_DEAD
+    bot_move best(const bot_board& b, const int* seq, int n, const bot_move& from, unsigned threads = 1) {
+        if (n > BOT_MAX_PLY) n = BOT_MAX_PLY;
+        tt_.new_search();
+        searches_++;
+        reach_.run(b, pieces_[seq[0]], from.ro, from.x, from.y);
+        std::vector<bot_move> moves(reach_.count());
+        for (int k = 0; k < reach_.count(); k++) moves[k] = reach_.landing(k);
+        std::vector<float> value(moves.size(), BOT_DEAD);
+        if (threads < 1) threads = 1;
+        if (threads > moves.size()) threads = static_cast<unsigned>(moves.size() ? moves.size() : 1);
+        std::vector<thread_stats> stats(threads);
+        auto work = [&](unsigned t) {
+            for (size_t k = t; k < moves.size(); k += threads) {
+                bot_board c = b;
+                int lines = c.place(pieces_[seq[0]], moves[k].ro, moves[k].x, moves[k].y);
+                moves[k].lines = lines;
+                value[k] = BOT_LINE_WEIGHT * lines + search(c, seq, 1, n, stats[t]);
+            }
+        };
+        if (threads == 1) {
+            work(0);
+        } else {
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < threads; t++) pool.push_back(std::thread(work, t));
+            work(0);
+            for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+        }
+        bot_move r = {0, 0, 0, 0, BOT_DEAD};
+        for (size_t k = 0; k < moves.size(); k++) {
+            if (value[k] > r.score) {
+                r = moves[k];
+                r.score = value[k];
+            }
+        }
+        for (unsigned t = 0; t < threads; t++) {
+            nodes_ += stats[t].nodes;
+            counts_ += stats[t].tt;
+        }
+        return r;
+    }
+
+    // ǰ cur  target һbot_stepʱ -1ÿΰǰã
+    // ѷȥ֮ܽ
+    int next_step(const bot_board& b, int piece, const bot_move& cur, const bot_move& target) {
+        return reach_.first_step(b, pieces_[piece], cur, target);
+    }
+
+    const bot_piece& piece(int k) const { return pieces_[k]; }
+    TranspositionTable& table() { return tt_; }
+    tt_stats table_stats() const { return tt_.stats(counts_); }
+    uint64_t nodes() const { return nodes_; }         // չľûУ
+    uint64_t searches() const { return searches_; }
+
+private:
+    // ÿ߳һݣռһ
+    struct alignas(64) thread_stats {
+        uint64_t    nodes;
+        tt_counters tt;
+        thread_stats() : nodes(0) {}
+    };
+
+    //  b ϻҪ seq[k..n-1] ʱܴﵽֵ
+    float search(const bot_board& b, const int* seq, int k, int n, thread_stats& ts) {
+        if (k == n) {
+            ts.nodes++;
+            return bot_evaluate(b);
+        }
+        const bool keyed = use_tt_ && n - k >= BOT_TT_MIN_LEFT;
+        uint64_t key = 0;
+        if (keyed) {
+            const bot_zobrist& z = bot_zobrist::get();
+            key = b.hash;
+            for (int i = k; i < n; i++) key ^= z.piece[i - k][seq[i]];
+            tt_hit hit;
+            if (tt_.probe(key, hit, ts.tt)) {
+                float v;
+                memcpy(&v, &hit.value, sizeof(v));
+                return v;
+            }
+        }
+        ts.nodes++;
+        const bot_piece& p = pieces_[seq[k]];
+        float v = BOT_DEAD;
+        uint16_t best_move = 0;
+        bot_for_each_drop(b, p, [&](int ro, int x, int y) {
+            bot_board c = b;
+            int lines = c.place(p, ro, x, y);
+            float cv = BOT_LINE_WEIGHT * lines + search(c, seq, k + 1, n, ts);
+            if (cv > v) {
+                v = cv;
+                best_move = bot_pack_move(ro, x, y);
+            }
+        });
+        if (keyed) {
+            uint32_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            tt_.store(key, bits, best_move, static_cast<uint8_t>(n - k), ts.tt);
+        }
+        return v;
+    }
+
+    TetrisBot(const TetrisBot&);
+    TetrisBot& operator=(const TetrisBot&);
+
+    std::vector<bot_piece> pieces_;
+    TranspositionTable     tt_;
+    bool                   use_tt_;
+    bot_reach              reach_;          // ֻڸڵ㣨̣߳
+    uint64_t               nodes_, searches_;
+    tt_counters            counts_;
+};
+
+#endif
@@ -0,0 +1,229 @@
+/*
+  ޽Ķ˹Ծ֣ͷļ ˹.cpp ͬģʽй
+    -  tetris_bot.h  bot_board  bot_piece ԤŲŵֻǼΰλ
+    - ״̬FALLING 1000/Ѷ ƽ ʱ CLEARINGͣ CLEAR_MSӦԭ˸
+       СƷ֡һ  FALLING鴦ռʱһ棬û˽ OVERRESTART_MS ؿ
+    - Լʱtick(now) ƽһһθõõʱ̣ɵߣʱ֣ʱ
+    - 룺encode_delta() ֻϴηĻȱ˵УӷԤ״̬
+  С̶֮ٷڴ档
+  ֡ʽСˣu16 ȣֽڣ| 'F' | u32 ֡ | u16  | u8 Ԥ | u8  | u8 ״̬
+               | u32  | ÿλһ u16 루ϵ£
+*/
+#ifndef TETRIS_GAME_H
+#define TETRIS_GAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "piece_queue.h"
+#include "tetris_bot.h"
+
+enum game_state {
+    GAME_FALLING,
+    GAME_CLEARING,
+    GAME_OVER
+};
+
+// ͻ˷İÿһֽ
+enum game_key {
+    GAME_KEY_LEFT = 'L',
+    GAME_KEY_RIGHT = 'R',
+    GAME_KEY_ROTATE = 'U',
+    GAME_KEY_DOWN = 'D',
+    GAME_KEY_QUIT = 'Q'
+};
+
+class TetrisGame {
+public:
+    enum {
+        CLEAR_MS = 490,                 // ԭϷ˸ 7   70ms
+        RESTART_MS = 1000,
+        SPAWN_X = 4,
+        FRAME_HEAD = 2 + 14,
+        MAX_FRAME = FRAME_HEAD + 2 * BOT_H
+    };
+
+    TetrisGame() : pieces_(0), kinds_(0), games_(0), overs_(0) {}
+
+    // һ֣pieces ڼЧ
+    void start(const bot_piece* pieces, int kinds, piece_policy policy, uint64_t seed) {
+        pieces_ = pieces;
+        kinds_ = kinds;
+        policy_ = policy;
+        rng_.seed_with(seed, 0x5851F42D4C957F2Dull);
+        for (int k = 0; k < kinds && k < BOT_MAX_KINDS; k++) spawn_ro_[k] = static_cast<uint8_t>(rng_.below(4));
+        queue_.reset(kinds, policy, seed);
+        board_.clear();
+        score_ = 0;
+        diff_ = 1;
+        lives_ = 0;
+        seq_ = 0;
+        games_++;
+        full_ = true;
+        state_ = GAME_FALLING;
+        spawn();
+    }
+
+    // һػǷб仯ֻЧ
+    bool key(int k) {
+        if (state_ != GAME_FALLING) return false;
+        const bot_piece& p = pieces_[kind_];
+        switch (k) {
+        case GAME_KEY_ROTATE:
+            if (!board_.fits(p, (ro_ + 1) & 3, x_, y_)) return false;
+            ro_ = (ro_ + 1) & 3;
+            return true;
+        case GAME_KEY_LEFT:
+        case GAME_KEY_RIGHT: {
+            int nx = x_ + (k == GAME_KEY_LEFT ? -1 : 1);
+            if (!board_.fits(p, ro_, nx, y_)) return false;
+            x_ = nx;
+            return true;
+        }
+        case GAME_KEY_DOWN:
+            // ͬԭϷֻĿλãһ
+            if (board_.fits(p, ro_, x_, y_ + 2)) y_ += 2;
+            else if (board_.fits(p, ro_, x_, y_ + 1)) y_ += 1;
+            else return false;
+            return true;
+        }
+        return false;
+    }
+
+    // ʱ now ˣ룩ƽһһθõõʱ
+    uint64_t tick(uint64_t now) {
+        switch (state_) {
+        case GAME_FALLING:
+            if (board_.fits(pieces_[kind_], ro_, x_, y_ + 1)) {
+                y_++;
+                return now + interval();
+            }
+            if (lock()) {
+                state_ = GAME_CLEARING;
+                return now + CLEAR_MS;
+            }
+            spawn();
+            return now + (state_ == GAME_OVER ? unsigned(RESTART_MS) : interval());
+        case GAME_CLEARING: {
+            int lines = 0;
+            for (int i = 0; i < BOT_H; i++) lines += board_.row[i] == BOT_FULL;
+            board_.collapse();
+            score_ += 2 * lines - 1;
+            if (score_ >= diff_ * diff_ * 10 && diff_ <= 6) diff_++;
+            if (score_ >= 50 * (lives_ + 1) && lives_ <= 6) lives_++;
+            state_ = GAME_FALLING;
+            spawn();
+            return now + (state_ == GAME_OVER ? unsigned(RESTART_MS) : interval());
+        }
+        case GAME_OVER:
+        default:
+            overs_++;
+            start(pieces_, kinds_, policy_, (static_cast<uint64_t>(rng_.next()) << 32) | rng_.next());
+            return now + interval();
+        }
+    }
+
+    // ϴαб仯ʱ֡д out MAX_FRAME ֽڣֽûб仯 0
+    size_t encode_delta(uint8_t* out) {
+        uint16_t cur[BOT_H];
+        compose(cur);
+        uint32_t mask = 0;
+        for (int i = 0; i < BOT_H; i++)
+            if (cur[i] != sent_[i]) mask |= 1u << i;
+        if (full_) mask = (1u << BOT_H) - 1;
+        else if (!mask && score_ == sent_score_ && next() == sent_next_ && lives_ == sent_lives_ && state_ == sent_state_)
+            return 0;
+        full_ = false;
+        uint8_t* p = out + 2;
+        *p++ = 'F';
+        p = put(p, seq_++, 4);
+        p = put(p, static_cast<uint32_t>(score_), 2);
+        *p++ = static_cast<uint8_t>(next());
+        *p++ = static_cast<uint8_t>(lives_);
+        *p++ = static_cast<uint8_t>(state_);
+        p = put(p, mask, 4);
+        for (int i = 0; i < BOT_H; i++)
+            if (mask >> i & 1) {
+                p = put(p, cur[i], 2);
+                sent_[i] = cur[i];
+            }
+        put(out, static_cast<uint32_t>(p - out - 2), 2);
+        sent_score_ = score_;
+        sent_next_ = next();
+        sent_lives_ = lives_;
+        sent_state_ = state_;
+        return static_cast<size_t>(p - out);
+    }
+
+    // һα뷢棨ӡͻ˶״̬ʱ
+    void force_full() { full_ = true; }
+
+    game_state state() const { return state_; }
+    int score() const { return score_; }
+    uint32_t games() const { return games_; }       // ֣һ֣
+    uint32_t overs() const { return overs_; }
+
+    // ǰ棺ķ
+    void compose(uint16_t rows[BOT_H]) const {
+        memcpy(rows, board_.row, sizeof(board_.row));
+        if (state_ != GAME_FALLING) return;
+        const bot_piece& p = pieces_[kind_];
+        for (int i = p.lo[ro_]; i <= p.hi[ro_]; i++) rows[y_ + i] |= p.cells[ro_][x_ + 3][i];
+    }
+
+private:
+    static uint8_t* put(uint8_t* p, uint32_t v, int n) {
+        for (int k = 0; k < n; k++) *p++ = static_cast<uint8_t>(v >> (8 * k));
+        return p;
+    }
+
+    unsigned interval() const { return 1000u / static_cast<unsigned>(diff_); }
+    int next() const { return queue_.peek(); }
+
+    // һ飻鴦ռʱ̣ͬ Block::lifeDownû˽
+    void spawn() {
+        kind_ = queue_.pop();
+        ro_ = spawn_ro_[kind_];
+        x_ = SPAWN_X;
+        y_ = 0;
+        if (board_.fits(pieces_[kind_], ro_, x_, y_)) return;
+        if (lives_) {
+            lives_--;
+            board_.clear();
+        } else {
+            state_ = GAME_OVER;
+        }
+    }
+
+    // ѷ̶ϣݲУǷ
+    bool lock() {
+        const bot_piece& p = pieces_[kind_];
+        bool full = false;
+        for (int i = p.lo[ro_]; i <= p.hi[ro_]; i++) {
+            board_.row[y_ + i] |= p.cells[ro_][x_ + 3][i];
+            full |= board_.row[y_ + i] == BOT_FULL;
+        }
+        return full;
+    }
+
+    const bot_piece* pieces_;
+    int              kinds_;
+    piece_policy     policy_;
+    pcg32            rng_;
+    PieceQueue       queue_;
+    bot_board        board_;
+    uint8_t          spawn_ro_[BOT_MAX_KINDS];
+    int              kind_, ro_, x_, y_;
+    int              score_, diff_, lives_;
+    game_state       state_;
+    uint32_t         seq_;
+    uint32_t         games_, overs_;
+    // ϴη
+    uint16_t         sent_[BOT_H];
+    int              sent_score_, sent_next_, sent_lives_;
+    game_state       sent_state_;
+    bool             full_;
+};
+
+#endif
@@ -0,0 +1,744 @@
+/*
+  ˹ѹͻˣͷļLinuxһйܳǧ tetris_game.h ĶԾ
+    - ÿ߳һ epollһʱ֣timer_wheel.h1 ̶ = 1msһԤȷõĶԾֲۣ
+      ̹߳һ׽֣EPOLLEXCLUSIVE˭˭ acceptһӾһ֣Ӵֻ߳
+    - ÿֵͣ١ؿʱϵһʱڵ TetrisGame::tickصʱ̸
+    - 룺ͻÿֽһ game_keyʹ
+    - ÿ¼꣬Իб仯ĶԾֱһ֡ддȥʱٱ֡
+       EPOLLOUT պٰ»롪ĿͻԶϲÿֵķͻ
+    - ԾֲۣԾ״̬ͻ塢ʱʱһη䣬Ͽֻڿȡ
+      ÿ̵ƽ롢շڴ
+    - ļ޷ⶥȻʱԤһסӲص롰Ѿܾ
+      ԤҲòͣˮƽļ׽߳̿ת
+    - ÿ report_ms һΣÿ/֡/Լ߳õ CPU ʱ䣬
+      ݴ˹㡰ÿܳŶپ֡ǰ  æµĺ
+  ַдunix:/· Ϊ Unix ׽֣Ϊ IPv4  :˿ڡ
+  ѹͻˣtetris_load_runͬ߳̽ṹ N ӣÿÿ key_ms һ
+  յÿһ֡ڱذԭ棬ʱ֡ʽͽľ
+*/
+#ifndef TETRIS_SERVER_H
+#define TETRIS_SERVER_H
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gbk_utf8.h"
+#include "tetris_game.h"
+#include "timer_wheel.h"
+
+#ifndef EPOLLEXCLUSIVE
+#  define EPOLLEXCLUSIVE (1u << 28)
+#endif
+
+struct server_config {
+    std::string  listen;                // Ĭ 127.0.0.1:7777
+    unsigned     threads;               // 0 = ߼
+    unsigned     max_games;             // ̺߳ϼ
+    piece_policy policy;
+    uint64_t     seed;
+    unsigned     report_ms;
+    double       duration;              // 룬0 = ֱ Ctrl+C
+};
+
+struct load_config {
+    std::string connect;
+    unsigned    clients;
+    unsigned    threads;
+    unsigned    key_ms;                 // ÿͻ˰ļ
+    double      duration;
+};
+
+namespace tserver_detail {
+
+inline std::atomic<bool>& stop_flag() {
+    static std::atomic<bool> f(false);
+    return f;
+}
+
+inline void on_signal(int) { stop_flag().store(true); }
+
+inline uint64_t now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// ߳õ CPU ʱ䣨ϵͳã߳ںʱǽʱѵȴҲȥ
+inline uint64_t cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// ҪͬļᵽӲޣյ
+inline uint64_t raise_fd_limit() {
+    rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0) return UINT64_MAX;
+    if (rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &rl) != 0) getrlimit(RLIMIT_NOFILE, &rl);
+    }
+    return rl.rlim_cur == RLIM_INFINITY ? UINT64_MAX : static_cast<uint64_t>(rl.rlim_cur);
+}
+
+struct address {
+    sockaddr_storage ss;
+    socklen_t        len;
+    int              family;
+};
+
+inline bool parse_address(const std::string& s, address& a) {
+    memset(&a, 0, sizeof(a));
+    if (s.compare(0, 5, "unix:") == 0) {
+        sockaddr_un* un = reinterpret_cast<sockaddr_un*>(&a.ss);
+        std::string path = s.substr(5);
+        if (path.empty() || path.size() >= sizeof(un->sun_path)) return false;
+        un->sun_family = AF_UNIX;
+        memcpy(un->sun_path, path.c_str(), path.size() + 1);
+        a.len = sizeof(sockaddr_un);
+        a.family = AF_UNIX;
+        return true;
+    }
+    size_t colon = s.rfind(':');
+    if (colon == std::string::npos) return false;
+    sockaddr_in* in = reinterpret_cast<sockaddr_in*>(&a.ss);
+    in->sin_family = AF_INET;
+    in->sin_port = htons(static_cast<uint16_t>(atoi(s.c_str() + colon + 1)));
+    std::string host = s.substr(0, colon);
+    if (host.empty()) host = "0.0.0.0";
+    if (inet_pton(AF_INET, host.c_str(), &in->sin_addr) != 1) return false;
+    a.len = sizeof(sockaddr_in);
+    a.family = AF_INET;
+    return true;
+}
+
+inline void set_nodelay(int fd, int family) {
+    if (family != AF_INET) return;
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+inline void report(const char* s) {
+    console_write(stderr, s, strlen(s));
+    fflush(stderr);
+}
+
+// ̵߳ۼƼֻɱ߳д߳ relaxed 
+struct alignas(64) worker_stats {
+    std::atomic<uint64_t> games, accepted, closed, rejected, ticks, frames, bytes, busy_ns;
+    worker_stats() : games(0), accepted(0), closed(0), rejected(0), ticks(0), frames(0), bytes(0), busy_ns(0) {}
+    void add(std::atomic<uint64_t>& c, uint64_t n) { c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+};
+
+// һռһۣԾ״̬붨ʱ
+struct game_slot {
+    enum { OUT_CAP = 4 * TetrisGame::MAX_FRAME };
+    TetrisGame         game;
+    TimerWheel::handle timer;
+    int                fd;
+    int32_t            next_free;
+    uint16_t           out_off, out_len;    // out[out_off, out_len) ûдȥ
+    bool               dirty, want_out;
+    uint8_t            out[OUT_CAP];
+};
+
+class ServerWorker {
+public:
+    ServerWorker(const std::vector<bot_piece>& pieces, const server_config& cfg, int listen_fd, int family,
+                 unsigned capacity, uint64_t seed, worker_stats& st)
+        : pieces_(pieces), cfg_(cfg), listen_fd_(listen_fd), family_(family), spare_(-1), paused_(false),
+          resume_at_(0), slots_(capacity), free_(-1), seed_(seed), serial_(0), t0_(0), st_(st) {
+        for (int32_t i = static_cast<int32_t>(capacity) - 1; i >= 0; i--) {
+            slots_[i].fd = -1;
+            slots_[i].next_free = free_;
+            free_ = i;
+        }
+        dirty_.reserve(capacity);
+        events_.resize(256);
+    }
+
+    void run() {
+        ep_ = epoll_create1(EPOLL_CLOEXEC);
+        spare_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        watch_listen();
+        t0_ = now_ns();
+        while (!stop_flag().load(std::memory_order_relaxed)) {
+            uint64_t now = ms();
+            if (paused_ && now >= resume_at_) watch_listen();
+            uint64_t next = wheel_.next_tick();
+            int timeout = next == UINT64_MAX ? 100 : next <= now ? 0 : static_cast<int>(next - now < 100 ? next - now : 100);
+            int n = epoll_wait(ep_, &events_[0], static_cast<int>(events_.size()), timeout);
+            for (int k = 0; k < n; k++) {
+                uint64_t id = events_[k].data.u64;
+                if (id == LISTEN) accept_all();
+                else handle(static_cast<int32_t>(id), events_[k].events);
+            }
+            wheel_.advance((now_ns() - t0_) / 1000000, [this](const std::vector<TimerWheel::event>& fired) {
+                for (size_t k = 0; k < fired.size(); k++) {
+                    int32_t i = static_cast<int32_t>(wheel_.user(fired[k].h));
+                    game_slot& s = slots_[i];
+                    wheel_.reschedule(fired[k].h, s.game.tick(fired[k].due));
+                    mark(i);
+                }
+                st_.add(st_.ticks, fired.size());
+            });
+            flush_dirty();
+            st_.busy_ns.store(cpu_ns(), std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < slots_.size(); i++)
+            if (slots_[i].fd >= 0) close_slot(static_cast<int32_t>(i));
+        if (spare_ >= 0) close(spare_);
+        close(ep_);
+    }
+
+private:
+    static const uint64_t LISTEN = ~0ull;
+
+    uint64_t ms() const { return (now_ns() - t0_) / 1000000; }
+
+    // ׽ˮƽģӲߵڶepoll_wait ٷأ߳̿ת
+    void watch_listen() {
+        epoll_event ev;
+        ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+        ev.data.u64 = LISTEN;
+        epoll_ctl(ep_, EPOLL_CTL_ADD, listen_fd_, &ev);
+        paused_ = false;
+        if (spare_ < 0) spare_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
+
+    // ʱܼ׽֣100ms жԾֽʱٽ
+    void pause_listen() {
+        if (paused_) return;
+        epoll_ctl(ep_, EPOLL_CTL_DEL, listen_fd_, 0);
+        paused_ = true;
+        resume_at_ = ms() + 100;
+    }
+
+    // ļ꣨EMFILE/ENFILEóԤһصٰԤû
+    // ԤòͣǷܽ accept
+    bool shed_one() {
+        if (spare_ < 0) {
+            pause_listen();
+            return false;
+        }
+        close(spare_);
+        int fd = accept4(listen_fd_, 0, 0, SOCK_CLOEXEC);
+        if (fd >= 0) {
+            close(fd);
+            st_.add(st_.rejected, 1);
+        }
+        spare_ = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (spare_ < 0) pause_listen();
+        return fd >= 0 && spare_ >= 0;
+    }
+
+    // һ 32 ʣµѵ̣߳ӷֵþЩ
+    void accept_all() {
+        for (int k = 0; k < 32; k++) {
+            int fd = accept4(listen_fd_, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                if (errno == EMFILE || errno == ENFILE) {
+                    if (shed_one()) continue;
+                    return;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK) pause_listen();    // ENOBUFS ȣԺ
+                return;                         // EAGAIN߳˻ȡ
+            }
+            if (free_ < 0) {
+                close(fd);
+                st_.add(st_.rejected, 1);
+                continue;
+            }
+            set_nodelay(fd, family_);
+            int32_t i = free_;
+            game_slot& s = slots_[i];
+            free_ = s.next_free;
+            s.fd = fd;
+            s.out_off = s.out_len = 0;
+            s.dirty = s.want_out = false;
+            s.game.start(&pieces_[0], static_cast<int>(pieces_.size()), cfg_.policy, seed_ + serial_++ * 0x9E3779B97F4A7C15ull);
+            uint64_t now = ms();
+            s.timer = wheel_.add(no_name_, now + 1000, static_cast<uint64_t>(i));
+            epoll_event ev;
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.u64 = static_cast<uint64_t>(i);
+            epoll_ctl(ep_, EPOLL_CTL_ADD, fd, &ev);
+            mark(i);
+            st_.add(st_.accepted, 1);
+            st_.add(st_.games, 1);
+        }
+    }
+
+    void handle(int32_t i, uint32_t events) {
+        game_slot& s = slots_[i];
+        if (s.fd < 0) return;
+        if (events & EPOLLIN) {
+            uint8_t buf[64];
+            for (;;) {
+                ssize_t n = read(s.fd, buf, sizeof(buf));
+                if (n > 0) {
+                    for (ssize_t k = 0; k < n; k++) {
+                        if (buf[k] == GAME_KEY_QUIT) {
+                            close_slot(i);
+                            return;
+                        }
+                        if (s.game.key(buf[k])) mark(i);
+                    }
+                    continue;
+                }
+                if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    close_slot(i);
+                    return;
+                }
+                if (errno == EAGAIN) break;
+            }
+        }
+        if (events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
+            close_slot(i);
+            return;
+        }
+        if (events & EPOLLOUT) {
+            if (!drain(s)) {
+                close_slot(i);
+                return;
+            }
+            if (s.out_off == s.out_len) mark(i);        // ˣ»油һ֡
+        }
+    }
+
+    void mark(int32_t i) {
+        if (slots_[i].dirty) return;
+        slots_[i].dirty = true;
+        dirty_.push_back(i);
+    }
+
+    // дݣ false
+    bool drain(game_slot& s) {
+        while (s.out_off < s.out_len) {
+            ssize_t n = send(s.fd, s.out + s.out_off, s.out_len - s.out_off, MSG_NOSIGNAL);
+            if (n > 0) {
+                s.out_off = static_cast<uint16_t>(s.out_off + n);
+                st_.add(st_.bytes, static_cast<uint64_t>(n));
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && errno == EAGAIN) {
+                break;
+            } else {
+                return false;
+            }
+        }
+        bool pending = s.out_off < s.out_len;
+        if (!pending) s.out_off = s.out_len = 0;
+        if (pending != s.want_out) {
+            epoll_event ev;
+            ev.events = EPOLLIN | EPOLLRDHUP | (pending ? uint32_t(EPOLLOUT) : 0u);
+            ev.data.u64 = static_cast<uint64_t>(&s - &slots_[0]);
+            epoll_ctl(ep_, EPOLL_CTL_MOD, s.fd, &ev);
+            s.want_out = pending;
+        }
+        return true;
+    }
+
+    void flush_dirty() {
+        for (size_t k = 0; k < dirty_.size(); k++) {
+            int32_t i = dirty_[k];
+            game_slot& s = slots_[i];
+            s.dirty = false;
+            if (s.fd < 0 || s.out_len) continue;        // ѶϿһ֡ûд꣨EPOLLOUT ٲ
+            size_t n = s.game.encode_delta(s.out);
+            if (!n) continue;
+            s.out_len = static_cast<uint16_t>(n);
+            st_.add(st_.frames, 1);
+            if (!drain(s)) close_slot(i);
+        }
+        dirty_.clear();
+    }
+
+    void close_slot(int32_t i) {
+        game_slot& s = slots_[i];
+        close(s.fd);                                    // رʱԶ epoll Ƴ
+        s.fd = -1;
+        wheel_.cancel(s.timer);
+        s.next_free = free_;
+        free_ = i;
+        if (paused_) resume_at_ = 0;                    // ڳһ־ͻָ
+        st_.add(st_.closed, 1);
+        st_.add(st_.games, static_cast<uint64_t>(-1));
+    }
+
+    const std::vector<bot_piece>& pieces_;
+    const server_config&          cfg_;
+    int                           listen_fd_, family_, ep_;
+    int                           spare_;           // Ԥʱóסص
+    bool                          paused_;
+    uint64_t                      resume_at_;
+    std::vector<game_slot>        slots_;
+    int32_t                       free_;
+    std::vector<int32_t>          dirty_;
+    std::vector<epoll_event>      events_;
+    TimerWheel                    wheel_;
+    const std::string             no_name_;
+    uint64_t                      seed_, serial_, t0_;
+    worker_stats&                 st_;
+};
+
+inline std::string human(double v) {
+    char tmp[32];
+    static const char* const unit[] = {"", "k", "M", "G"};
+    int k = 0;
+    while (v >= 1000.0 && k < 3) {
+        v /= 1000.0;
+        k++;
+    }
+    snprintf(tmp, sizeof(tmp), v < 10 ? "%.2f%s" : v < 100 ? "%.1f%s" : "%.0f%s", v, unit[k]);
+    return tmp;
+}
+
+// ͻһࣺһһ֣ԭ
+struct load_conn {
+    int                fd;
+    bool               connected;
+    TimerWheel::handle timer;
+    uint16_t           in_len;
+    uint8_t            in[512];
+    uint16_t           rows[BOT_H];
+    uint8_t            last_state;
+};
+
+struct alignas(64) load_stats {
+    std::atomic<uint64_t> connected, frames, bytes, keys, overs, errors, refused;
+    load_stats() : connected(0), frames(0), bytes(0), keys(0), overs(0), errors(0), refused(0) {}
+    void add(std::atomic<uint64_t>& c, uint64_t n) { c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+};
+
+class LoadWorker {
+public:
+    LoadWorker(const load_config& cfg, const address& addr, unsigned count, uint64_t seed, load_stats& st)
+        : cfg_(cfg), addr_(addr), conns_(count), rng_(seed), st_(st), ep_(-1), t0_(0) {}
+
+    void run() {
+        ep_ = epoll_create1(EPOLL_CLOEXEC);
+        t0_ = now_ns();
+        std::vector<epoll_event> events(256);
+        for (size_t i = 0; i < conns_.size(); i++) {
+            conns_[i].fd = -1;
+            // ӷɢڵһ﷢𣬱˲伷
+            conns_[i].timer = wheel_.add(no_name_, 1 + rng_.below(cfg_.key_ms ? cfg_.key_ms : 1), i);
+        }
+        while (!stop_flag().load(std::memory_order_relaxed)) {
+            uint64_t now = ms();
+            uint64_t next = wheel_.next_tick();
+            int timeout = next == UINT64_MAX ? 100 : next <= now ? 0 : static_cast<int>(next - now < 100 ? next - now : 100);
+            int n = epoll_wait(ep_, &events[0], static_cast<int>(events.size()), timeout);
+            for (int k = 0; k < n; k++) handle(static_cast<uint32_t>(events[k].data.u64), events[k].events);
+            wheel_.advance(ms(), [this](const std::vector<TimerWheel::event>& fired) {
+                for (size_t k = 0; k < fired.size(); k++) {
+                    uint32_t i = static_cast<uint32_t>(wheel_.user(fired[k].h));
+                    load_conn& c = conns_[i];
+                    if (c.fd < 0) {
+                        open_conn(i);
+                    } else if (c.connected) {
+                        static const char keys[] = {GAME_KEY_LEFT, GAME_KEY_RIGHT, GAME_KEY_ROTATE, GAME_KEY_DOWN};
+                        char key = keys[rng_.below(4)];
+                        if (send(c.fd, &key, 1, MSG_NOSIGNAL) == 1) st_.add(st_.keys, 1);
+                    }
+                    wheel_.reschedule(fired[k].h, fired[k].due + (cfg_.key_ms ? cfg_.key_ms : 1));
+                }
+            });
+        }
+        for (size_t i = 0; i < conns_.size(); i++)
+            if (conns_[i].fd >= 0) close(conns_[i].fd);
+        close(ep_);
+    }
+
+private:
+    uint64_t ms() const { return (now_ns() - t0_) / 1000000; }
+
+    void open_conn(uint32_t i) {
+        load_conn& c = conns_[i];
+        c.fd = socket(addr_.family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (c.fd < 0) return;
+        c.connected = false;
+        c.in_len = 0;
+        c.last_state = GAME_FALLING;
+        memset(c.rows, 0, sizeof(c.rows));
+        if (connect(c.fd, reinterpret_cast<const sockaddr*>(&addr_.ss), addr_.len) < 0 && errno != EINPROGRESS) {
+            drop(i);
+            return;
+        }
+        set_nodelay(c.fd, addr_.family);
+        epoll_event ev;
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+        ev.data.u64 = i;
+        epoll_ctl(ep_, EPOLL_CTL_ADD, c.fd, &ev);
+    }
+
+    // ʧܻ򱻶Ͽصȶʱ´εʱ
+    void drop(uint32_t i) {
+        load_conn& c = conns_[i];
+        if (c.connected) st_.add(st_.connected, static_cast<uint64_t>(-1));
+        else st_.add(st_.refused, 1);
+        close(c.fd);
+        c.fd = -1;
+        c.connected = false;
+    }
+
+    void handle(uint32_t i, uint32_t events) {
+        load_conn& c = conns_[i];
+        if (c.fd < 0) return;
+        if (!c.connected && (events & EPOLLOUT)) {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            getsockopt(c.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+            if (err) {
+                drop(i);
+                return;
+            }
+            c.connected = true;
+            st_.add(st_.connected, 1);
+            epoll_event ev;
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.u64 = i;
+            epoll_ctl(ep_, EPOLL_CTL_MOD, c.fd, &ev);
+        }
+        if (events & EPOLLIN) {
+            for (;;) {
+                ssize_t n = read(c.fd, c.in + c.in_len, sizeof(c.in) - c.in_len);
+                if (n > 0) {
+                    st_.add(st_.bytes, static_cast<uint64_t>(n));
+                    c.in_len = static_cast<uint16_t>(c.in_len + n);
+                    parse(c);
+                    continue;
+                }
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0 && errno == EAGAIN) break;
+                drop(i);
+                return;
+            }
+        }
+        if (events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) drop(i);
+    }
+
+    // ֡Ӧõػ棻Բʽ
+    void parse(load_conn& c) {
+        size_t off = 0;
+        while (c.in_len - off >= 2) {
+            size_t len = c.in[off] | c.in[off + 1] << 8;
+            if (c.in_len - off < 2 + len) break;
+            const uint8_t* p = c.in + off + 2;
+            uint32_t mask = len >= 14 ? (p[10] | p[11] << 8 | p[12] << 16 | static_cast<uint32_t>(p[13]) << 24) : 0;
+            if (len < 14 || p[0] != 'F' || mask >> BOT_H || len != 14 + 2 * static_cast<size_t>(bot_popcount(mask))) {
+                st_.add(st_.errors, 1);
+            } else {
+                const uint8_t* r = p + 14;
+                for (int row = 0; row < BOT_H; row++)
+                    if (mask >> row & 1) {
+                        c.rows[row] = static_cast<uint16_t>(r[0] | r[1] << 8);
+                        r += 2;
+                    }
+                if (p[9] == GAME_OVER && c.last_state != GAME_OVER) st_.add(st_.overs, 1);
+                c.last_state = p[9];
+                st_.add(st_.frames, 1);
+            }
+            off += 2 + len;
+        }
+        if (off) {
+            memmove(c.in, c.in + off, c.in_len - off);
+            c.in_len = static_cast<uint16_t>(c.in_len - off);
+        }
+        if (c.in_len == sizeof(c.in)) {     // һ֡Ȼ廹󣺸ʽ϶
+            st_.add(st_.errors, 1);
+            c.in_len = 0;
+        }
+    }
+
+    const load_config&     cfg_;
+    const address&         addr_;
+    std::vector<load_conn> conns_;
+    pcg32                  rng_;
+    load_stats&            st_;
+    TimerWheel             wheel_;
+    const std::string      no_name_;
+    int                    ep_;
+    uint64_t               t0_;
+};
+
+inline unsigned pick_threads(unsigned n) {
+    if (n) return n;
+    n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+} // namespace tserver_detail
+
+// зֱ duration 뵽յ SIGINT/SIGTERMֱֵΪ main ķֵ
+inline int tetris_server_run(const std::vector<bot_piece>& pieces, const server_config& cfg) {
+    using namespace tserver_detail;
+    uint64_t fd_limit = raise_fd_limit();
+    address addr;
+    std::string where = cfg.listen.empty() ? "127.0.0.1:7777" : cfg.listen;
+    if (!parse_address(where, addr)) {
+        fprintf(stderr, "bad address: %s\n", where.c_str());
+        return 1;
+    }
+    int fd = socket(addr.family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int one = 1;
+    if (addr.family == AF_UNIX) unlink(reinterpret_cast<sockaddr_un*>(&addr.ss)->sun_path);
+    else setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (fd < 0 || bind(fd, reinterpret_cast<const sockaddr*>(&addr.ss), addr.len) < 0 || listen(fd, SOMAXCONN) < 0) {
+        fprintf(stderr, "cannot listen on %s: %s\n", where.c_str(), strerror(errno));
+        return 1;
+    }
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    unsigned threads = pick_threads(cfg.threads);
+    unsigned per = (cfg.max_games + threads - 1) / threads;
+    // ÿһ׼׽ֺÿ̵߳ epoll Ԥ
+    uint64_t fd_room = fd_limit > 16 + 2 * threads ? (fd_limit - 16 - 2 * threads) / threads : 0;
+    if (per > fd_room) {
+        char note[160];
+        snprintf(note, sizeof(note), "ļ %lluÿ߳ %llu ֣ --max-games ӦΪ %u\n",
+                 static_cast<unsigned long long>(fd_limit), static_cast<unsigned long long>(fd_room), per);
+        report(note);
+        per = static_cast<unsigned>(fd_room);
+    }
+    std::vector<worker_stats> stats(threads);
+    std::vector<ServerWorker*> workers;
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++)
+        workers.push_back(new ServerWorker(pieces, cfg, fd, addr.family, per, cfg.seed + t * 0xD1B54A32D192ED03ull, stats[t]));
+    for (unsigned t = 0; t < threads; t++) pool.push_back(std::thread(&ServerWorker::run, workers[t]));
+
+    char line[512];
+    snprintf(line, sizeof(line), "˹%s%u ̣߳ %u \n", where.c_str(), threads, per * threads);
+    report(line);
+    uint64_t start = now_ns(), last = start;
+    uint64_t prev_ticks = 0, prev_frames = 0, prev_bytes = 0, prev_busy = 0;
+    std::vector<double> per_core_samples;
+    unsigned report_ms = cfg.report_ms ? cfg.report_ms : 1000;
+    while (!stop_flag().load()) {
+        for (unsigned slept = 0; slept < report_ms && !stop_flag().load(); slept += 20) usleep(20000);
+        uint64_t now = now_ns();
+        if (cfg.duration > 0 && (now - start) / 1e9 >= cfg.duration) stop_flag().store(true);
+        uint64_t games = 0, ticks = 0, frames = 0, bytes = 0, busy = 0, rejected = 0;
+        for (unsigned t = 0; t < threads; t++) {
+            games += stats[t].games.load(std::memory_order_relaxed);
+            ticks += stats[t].ticks.load(std::memory_order_relaxed);
+            frames += stats[t].frames.load(std::memory_order_relaxed);
+            bytes += stats[t].bytes.load(std::memory_order_relaxed);
+            busy += stats[t].busy_ns.load(std::memory_order_relaxed);
+            rejected += stats[t].rejected.load(std::memory_order_relaxed);
+        }
+        double sec = (now - last) / 1e9;
+        double cores = (busy - prev_busy) / 1e9 / sec;         // æµĺ
+        double per_core = cores > 0 ? games / cores : 0;
+        if (games >= threads && per_core > 0) per_core_samples.push_back(per_core);
+        snprintf(line, sizeof(line),
+                 "Ծ %llu  / %s  ֡/ %s   %sB/s  æµ %.1f%%   Լÿ %s %s\n",
+                 static_cast<unsigned long long>(games), human((ticks - prev_ticks) / sec).c_str(),
+                 human((frames - prev_frames) / sec).c_str(), human((bytes - prev_bytes) / sec).c_str(), cores * 100,
+                 per_core > 0 ? human(per_core).c_str() : "-",
+                 rejected ? ("  Ѿܾ " + std::to_string(rejected)).c_str() : "");
+        report(line);
+        prev_ticks = ticks;
+        prev_frames = frames;
+        prev_bytes = bytes;
+        prev_busy = busy;
+        last = now;
+    }
+    for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+    for (size_t t = 0; t < workers.size(); t++) delete workers[t];
+    close(fd);
+    if (addr.family == AF_UNIX) unlink(reinterpret_cast<sockaddr_un*>(&addr.ss)->sun_path);
+    if (!per_core_samples.empty()) {
+        std::sort(per_core_samples.begin(), per_core_samples.end());
+        snprintf(line, sizeof(line), " %u λܵλ㣺ÿԼ %s \n",
+                 static_cast<unsigned>(per_core_samples.size()), human(per_core_samples[per_core_samples.size() / 2]).c_str());
+        report(line);
+    }
+    return 0;
+}
+
+// ѹ⣺ clients  duration 룬ʱ棻ֱֵΪ main ķֵ
+inline int tetris_load_run(const load_config& cfg) {
+    using namespace tserver_detail;
+    raise_fd_limit();
+    address addr;
+    std::string where = cfg.connect.empty() ? "127.0.0.1:7777" : cfg.connect;
+    if (!parse_address(where, addr)) {
+        fprintf(stderr, "bad address: %s\n", where.c_str());
+        return 1;
+    }
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    unsigned threads = pick_threads(cfg.threads);
+    if (!cfg.clients) return 0;
+    if (threads > cfg.clients) threads = cfg.clients;
+    std::vector<load_stats> stats(threads);
+    std::vector<LoadWorker*> workers;
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        unsigned n = cfg.clients / threads + (t < cfg.clients % threads ? 1 : 0);
+        workers.push_back(new LoadWorker(cfg, addr, n, 0x243F6A8885A308D3ull + t, stats[t]));
+    }
+    uint64_t start = now_ns();
+    for (unsigned t = 0; t < threads; t++) pool.push_back(std::thread(&LoadWorker::run, workers[t]));
+    double duration = cfg.duration > 0 ? cfg.duration : 10;
+    while (!stop_flag().load() && (now_ns() - start) / 1e9 < duration) usleep(20000);
+    stop_flag().store(true);
+    for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+    double sec = (now_ns() - start) / 1e9;
+    uint64_t connected = 0, frames = 0, bytes = 0, keys = 0, overs = 0, errors = 0, refused = 0;
+    for (unsigned t = 0; t < threads; t++) {
+        connected += stats[t].connected.load();
+        frames += stats[t].frames.load();
+        bytes += stats[t].bytes.load();
+        keys += stats[t].keys.load();
+        overs += stats[t].overs.load();
+        errors += stats[t].errors.load();
+        refused += stats[t].refused.load();
+        delete workers[t];
+    }
+    char line[512];
+    snprintf(line, sizeof(line),
+             "ѹ %s%u ͻˡ%u ̡߳%.1f 룻 %lluʧ %llu\n"
+             "  յ %llu ֡%s ֡/룬ƽ %.1f ֽڣ%sB/s %llu %llu ֣ʽ %llu\n",
+             where.c_str(), cfg.clients, threads, sec, static_cast<unsigned long long>(connected),
+             static_cast<unsigned long long>(refused), static_cast<unsigned long long>(frames), human(frames / sec).c_str(),
+             frames ? static_cast<double>(bytes) / frames : 0.0, human(bytes / sec).c_str(),
+             static_cast<unsigned long long>(keys), static_cast<unsigned long long>(overs),
+             static_cast<unsigned long long>(errors));
+    report(line);
+    return errors ? 1 : 0;
+}
+
+#endif // __linux__
+
+#endif
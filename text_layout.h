@@ -0,0 +1,161 @@
+/*
+  ıŰ棨ͷļնʾȶ룬ǰֽ
+    - display_widthUTF-8  GBK ıڵȿնռУֵȿַ 2 УϷ 0 У
+    - TextLayoutа//ҶŽͬһ黺壬һд
+  setw ֽڲ룬ͬһ GBK ռ 2 ֽڡ UTF-8 ռ 3 ֽڣȾͶԲϣ
+   endl ֻÿˢһΡȰıźãپ gbk_utf8.h תն˱һд
+*/
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "gbk_utf8.h"
+
+enum text_align {
+    ALIGN_LEFT,
+    ALIGN_CENTER,
+    ALIGN_RIGHT
+};
+
+namespace text_layout_detail {
+
+//  s[i]  ASCII ֽڵĸÿμ 8 ֽ
+inline size_t ascii_run(const char* s, size_t i, size_t n) {
+    size_t j = i;
+    while (j + 8 <= n) {
+        uint64_t w;
+        std::memcpy(&w, s + j, 8);
+        if (w & 0x8080808080808080ull) break;
+        j += 8;
+    }
+    while (j < n && !(static_cast<unsigned char>(s[j]) & 0x80)) j++;
+    return j - i;
+}
+
+inline bool in(uint32_t c, uint32_t lo, uint32_t hi) { return c >= lo && c <= hi; }
+
+// λʾȣȡ Unicode ǿַW/FҪΣϷźַΪ 0
+inline int codepoint_width(uint32_t c) {
+    if (c < 0x20 || in(c, 0x7F, 0x9F)) return 0;
+    if (in(c, 0x0300, 0x036F) || in(c, 0x200B, 0x200F) || in(c, 0x20D0, 0x20FF) ||
+        in(c, 0xFE00, 0xFE0F) || c == 0xFEFF)
+        return 0;
+    if (in(c, 0x1100, 0x115F) || in(c, 0x2E80, 0x303E) || in(c, 0x3041, 0x33FF) ||
+        in(c, 0x3400, 0x4DBF) || in(c, 0x4E00, 0x9FFF) || in(c, 0xA000, 0xA4CF) ||
+        in(c, 0xAC00, 0xD7A3) || in(c, 0xF900, 0xFAFF) || in(c, 0xFE30, 0xFE4F) ||
+        in(c, 0xFF00, 0xFF60) || in(c, 0xFFE0, 0xFFE6) || in(c, 0x1F300, 0x1F64F) ||
+        in(c, 0x1F900, 0x1F9FF) || in(c, 0x20000, 0x3FFFD))
+        return 2;
+    return 1;
+}
+
+} // namespace text_layout_detail
+
+// ıڵȿնϵASCII ַռУȱĶֽÿֽڰ 1 м
+inline size_t display_width(const char* s, size_t n, text_encoding enc) {
+    using namespace text_layout_detail;
+    size_t w = 0, i = 0;
+    while (i < n) {
+        size_t run = ascii_run(s, i, n);
+        if (run) {
+            for (size_t k = i; k < i + run; k++) w += static_cast<unsigned char>(s[k]) >= 0x20 && s[k] != 0x7F;
+            i += run;
+            continue;
+        }
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (enc == TEXT_GBK) {
+            // GBK ˫ֽڣֽ 0x81-0xFEֽ 0x40-0xFE 0x7Fռ 2 
+            if (c >= 0x81 && c <= 0xFE && i + 1 < n) {
+                unsigned char d = static_cast<unsigned char>(s[i + 1]);
+                if (d >= 0x40 && d <= 0xFE && d != 0x7F) {
+                    w += 2;
+                    i += 2;
+                    continue;
+                }
+            }
+            w++;
+            i++;
+            continue;
+        }
+        int len = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+        if (len == 1 || i + len > n) {
+            w++;
+            i++;
+            continue;
+        }
+        uint32_t cp = c & (0x7F >> len);
+        bool ok = true;
+        for (int k = 1; k < len; k++) {
+            unsigned char d = static_cast<unsigned char>(s[i + k]);
+            ok = ok && (d & 0xC0) == 0x80;
+            cp = (cp << 6) | (d & 0x3F);
+        }
+        if (!ok) {
+            w++;
+            i++;
+            continue;
+        }
+        w += codepoint_width(cp);
+        i += len;
+    }
+    return w;
+}
+
+inline size_t display_width(const std::string& s, text_encoding enc) {
+    return display_width(s.data(), s.size(), enc);
+}
+
+class TextLayout {
+public:
+    // width ΪȣУpad_right ΪʱÿҲҲո
+    explicit TextLayout(size_t width, text_encoding enc = TEXT_LITERAL, bool pad_right = false)
+        : width_(width), enc_(enc), pad_right_(pad_right) {}
+
+    void reserve(size_t bytes) { buf_.reserve(bytes); }
+    void clear() { buf_.clear(); }
+
+    // ׷һУȵԭض
+    TextLayout& line(const char* s, size_t n, text_align a = ALIGN_LEFT) {
+        size_t w = display_width(s, n, enc_);
+        size_t gap = w < width_ ? width_ - w : 0;
+        size_t left = a == ALIGN_CENTER ? gap / 2 : a == ALIGN_RIGHT ? gap : 0;
+        buf_.append(left, ' ');
+        buf_.append(s, n);
+        if (pad_right_) buf_.append(gap - left, ' ');
+        buf_.push_back('\n');
+        return *this;
+    }
+    TextLayout& line(const std::string& s, text_align a = ALIGN_LEFT) { return line(s.data(), s.size(), a); }
+    TextLayout& line(const char* s, text_align a = ALIGN_LEFT) { return line(s, std::strlen(s), a); }
+
+    TextLayout& center(const char* s) { return line(s, ALIGN_CENTER); }
+    TextLayout& right(const char* s)  { return line(s, ALIGN_RIGHT); }
+
+    // ظַ cں
+    TextLayout& rule(char c = '-') {
+        buf_.append(width_, c);
+        buf_.push_back('\n');
+        return *this;
+    }
+
+    const std::string& str() const { return buf_; }
+
+    // תն˱һдȫݲˢ£Ƿдȫ
+    bool emit(FILE* f = stdout) const {
+        bool ok = console_write(f, buf_.data(), buf_.size(), enc_);
+        return std::fflush(f) == 0 && ok;
+    }
+
+private:
+    size_t        width_;
+    text_encoding enc_;
+    bool          pad_right_;
+    std::string   buf_;
+};
+
+#endif
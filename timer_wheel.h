@@ -0,0 +1,243 @@
+/*
+  ֲʱ֣һ߳ʱ
+    -  LEVELS 㣬ÿ 64 ۣ L ÿۿ 64^L ̶
+    - /ȡ/ڶ O(1)ֻһ˫ժ
+    - ̶ƽʱͲתһȦŰһӦĶʱ·š
+    - ڵĶʱܳһһλص
+  ̶ȵɵ߾ 1 tick = 1ms಻ֻӦǸ̵߳á
+*/
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class TimerWheel {
+public:
+    typedef uint64_t handle;                       // 32λΪ32λΪڵ±
+    static const int BITS   = 6;
+    static const int SLOTS  = 1 << BITS;           // ÿ
+    static const int LEVELS = 5;                   //  2^30 ̶ȣֹڶԶѭ
+
+    struct event {
+        handle   h;
+        uint64_t due;
+    };
+
+    explicit TimerWheel(uint64_t start_tick = 0) : cur_(start_tick), count_(0), free_(-1) {
+        for (int i = 0; i < LEVELS * SLOTS; i++) head_[i] = -1;
+        for (int l = 0; l < LEVELS; l++) occ_[l] = 0;
+    }
+
+    uint64_t now() const  { return cur_; }
+    size_t   size() const { return count_; }
+
+    // ½ʱڿ̶ due ڣuser ΪԶ
+    handle add(const std::string& name, uint64_t due, uint64_t user = 0) {
+        int32_t i = alloc();
+        node& n = nodes_[i];
+        n.name = name;
+        n.user = user;
+        n.due  = due;
+        place(i, cur_ + 1);
+        count_++;
+        return make_handle(i);
+    }
+
+    // ȡʱʧЧѵڲͷŻȡʱ false
+    bool cancel(handle h) {
+        int32_t i = lookup(h);
+        if (i < 0) return false;
+        if (nodes_[i].slot >= 0) unlink(i);
+        release(i);
+        count_--;
+        return true;
+    }
+
+    // ĵ̶ due ڣڵڻصԸյڵľüʵڶʱ
+    bool reschedule(handle h, uint64_t due) {
+        int32_t i = lookup(h);
+        if (i < 0) return false;
+        if (nodes_[i].slot >= 0) unlink(i);
+        nodes_[i].due = due;
+        place(i, cur_ + 1);
+        return true;
+    }
+
+    const std::string& name(handle h) const { return nodes_[index(h)].name; }
+    uint64_t user(handle h) const          { return nodes_[index(h)].user; }
+
+    // ·Ŀ̶ȣڻҪ·ţ߳̿һֱ˯̶ȡ
+    // ҵǰ֮һǿղۣȦ涼ȡתһȦĿ̶ȡ
+    uint64_t next_tick() const {
+        uint64_t best = UINT64_MAX;
+        for (int l = 0; l < LEVELS; l++) {
+            if (!occ_[l]) continue;
+            int sh = BITS * l;
+            uint64_t blk = cur_ >> sh;
+            uint64_t pos = blk & (SLOTS - 1);
+            uint64_t ahead = pos + 1 < SLOTS ? occ_[l] >> (pos + 1) : 0;
+            uint64_t t = ahead ? (blk + 1 + ctz(ahead)) << sh
+                               : ((blk | (SLOTS - 1)) + 1) << sh;
+            if (t < best) best = t;
+        }
+        return best;
+    }
+
+    // ƽ̶ toڼ䵽ڵĶʱΪһ fn(const std::vector<event>&)
+    // صڼδ reschedule ĵڶʱڻصغͷšرεڸ
+    template <class F>
+    size_t advance(uint64_t to, F&& fn) {
+        fired_.clear();
+        while (cur_ < to) {
+            uint64_t next = next_tick();
+            if (next > to) { cur_ = to; break; }
+            cur_ = next;
+            if ((cur_ & (SLOTS - 1)) == 0) cascade();
+            expire(0, static_cast<int>(cur_ & (SLOTS - 1)));
+        }
+        size_t n = fired_.size();
+        if (n) {
+            fn(static_cast<const std::vector<event>&>(fired_));
+            for (size_t k = 0; k < n; k++) {
+                int32_t i = lookup(fired_[k].h);
+                if (i >= 0 && nodes_[i].slot == FIRED) {
+                    release(i);
+                    count_--;
+                }
+            }
+        }
+        return n;
+    }
+
+private:
+    static const int32_t FREE  = -1;
+    static const int32_t FIRED = -2;
+
+    struct node {
+        uint64_t    due;
+        uint64_t    user;
+        int32_t     prev, next;
+        int32_t     slot;                           // ڲۣ*SLOTS+ۺţ FREE/FIRED
+        uint32_t    gen;
+        std::string name;
+    };
+
+    static int ctz(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(v);
+#else
+        int n = 0;
+        while (!(v & 1)) { v >>= 1; n++; }
+        return n;
+#endif
+    }
+    static int32_t index(handle h) { return static_cast<int32_t>(h & 0xFFFFFFFFu); }
+    handle make_handle(int32_t i) const {
+        return (static_cast<uint64_t>(nodes_[i].gen) << 32) | static_cast<uint32_t>(i);
+    }
+    int32_t lookup(handle h) const {
+        int32_t i = index(h);
+        if (i < 0 || static_cast<size_t>(i) >= nodes_.size()) return -1;
+        const node& n = nodes_[i];
+        if (n.slot == FREE || n.gen != static_cast<uint32_t>(h >> 32)) return -1;
+        return i;
+    }
+
+    int32_t alloc() {
+        if (free_ >= 0) {
+            int32_t i = free_;
+            free_ = nodes_[i].next;
+            return i;
+        }
+        nodes_.push_back(node());
+        nodes_.back().gen = 0;
+        return static_cast<int32_t>(nodes_.size() - 1);
+    }
+    void release(int32_t i) {
+        node& n = nodes_[i];
+        n.slot = FREE;
+        n.gen++;
+        n.next = free_;
+        free_ = i;
+    }
+
+    // ʣ̶ѡ㣬ڿ̶ȵĶӦλѡۣ earliest İ earliest 
+    void place(int32_t i, uint64_t earliest) {
+        uint64_t due = nodes_[i].due < earliest ? earliest : nodes_[i].due;
+        uint64_t delta = due - cur_;
+        int level = 0, slot;
+        while (level < LEVELS - 1 && delta >= (uint64_t(1) << (BITS * (level + 1)))) level++;
+        if (delta >= (uint64_t(1) << (BITS * LEVELS))) {
+            // ΧڶԶĲۣתʱ¼
+            slot = static_cast<int>(((cur_ >> (BITS * level)) + SLOTS - 1) & (SLOTS - 1));
+        } else {
+            slot = static_cast<int>((due >> (BITS * level)) & (SLOTS - 1));
+        }
+        link(i, level * SLOTS + slot);
+    }
+    void link(int32_t i, int32_t s) {
+        node& n = nodes_[i];
+        n.slot = s;
+        n.prev = -1;
+        n.next = head_[s];
+        if (n.next >= 0) nodes_[n.next].prev = i;
+        head_[s] = i;
+        occ_[s / SLOTS] |= uint64_t(1) << (s % SLOTS);
+    }
+    void unlink(int32_t i) {
+        node& n = nodes_[i];
+        int32_t s = n.slot;
+        if (n.prev >= 0) nodes_[n.prev].next = n.next;
+        else head_[s] = n.next;
+        if (n.next >= 0) nodes_[n.next].prev = n.prev;
+        if (head_[s] < 0) occ_[s / SLOTS] &= ~(uint64_t(1) << (s % SLOTS));
+        n.slot = FIRED;
+    }
+
+    //  0 תһȦӸߵͰѸ㵱ǰ·
+    void cascade() {
+        int top = 1;
+        while (top < LEVELS - 1 && ((cur_ >> (BITS * top)) & (SLOTS - 1)) == 0) top++;
+        for (int l = top; l >= 1; l--) {
+            int s = l * SLOTS + static_cast<int>((cur_ >> (BITS * l)) & (SLOTS - 1));
+            int32_t i = head_[s];
+            head_[s] = -1;
+            occ_[l] &= ~(uint64_t(1) << (s % SLOTS));
+            while (i >= 0) {
+                int32_t nx = nodes_[i].next;
+                place(i, cur_);
+                i = nx;
+            }
+        }
+    }
+    void expire(int level, int slot) {
+        int s = level * SLOTS + slot;
+        int32_t i = head_[s];
+        head_[s] = -1;
+        occ_[level] &= ~(uint64_t(1) << slot);
+        while (i >= 0) {
+            int32_t nx = nodes_[i].next;
+            node& n = nodes_[i];
+            if (n.due <= cur_) {
+                n.slot = FIRED;
+                event e = { make_handle(i), n.due };
+                fired_.push_back(e);
+            } else {
+                place(i, cur_);                     // Χڴ˴Ķʱλ
+            }
+            i = nx;
+        }
+    }
+
+    uint64_t           cur_;
+    size_t             count_;
+    int32_t            free_;
+    int32_t            head_[LEVELS * SLOTS];
+    uint64_t           occ_[LEVELS];                // ÿǿղλͼ
+    std::vector<node>  nodes_;
+    std::vector<event> fired_;
+};
+
+#endif
@@ -0,0 +1,320 @@
+/*
+  ȵ׮ͷļʱֱͼȼڸ߳ԼĻ
+    TRACE_SCOPE("tetris/check");        // Ӵ˴һʱͬʱֵĺʱֱͼ
+    TRACE_COUNT("grades/rows", n);      // ۼ n
+    TRACE_HIST("tetris/lines", k);      // ֱͼ¼һֵ
+  ֻж TRACE_ENABLED=1 ʱЧCMake-DBUILD_TRACE=ON  trace Ԥ裩
+  δʱչΪ䣬Ҳʵ֣Ա㿪
+  ˳ʱ
+    - мʱ¼д Chrome trace-event JSONchrome://tracing  Perfetto 򿪣
+      ļȡ TRACE_FILEĬ trace.jsonTRACE_FILE Ϊմʱд
+    -  stderr ӡܱÿĴܺʱƽp50/p99ֵԼֱͼ
+      TRACE_SUMMARY=0 ʱӡ
+  ¼·ÿ̵߳һμ¼ʱǼһ黺壬ֻ֮дԼġ
+  ÿ߳ౣ TRACE_MAX_EVENTS ʱ¼ֻܡ trace ļ
+   atexit нУʱڼ¼̵߳ݿܲ
+*/
+#ifndef TRACE_H
+#define TRACE_H
+
+#if defined(TRACE_ENABLED) && TRACE_ENABLED
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef TRACE_MAX_EVENTS
+#define TRACE_MAX_EVENTS (1u << 20)
+#endif
+
+namespace trace_detail {
+
+enum site_kind { SITE_SCOPE, SITE_COUNT, SITE_HIST };
+
+// -ֱͼÿ 2 ٷ 8 񣬷λԼ 12%
+struct hist {
+    enum { SUB = 8, BUCKETS = 64 * SUB };
+    uint64_t n, sum, lo, hi;
+    uint64_t b[BUCKETS];
+
+    hist() : n(0), sum(0), lo(UINT64_MAX), hi(0) { std::memset(b, 0, sizeof(b)); }
+
+    static unsigned bucket(uint64_t v) {
+        if (v < SUB) return static_cast<unsigned>(v);
+        unsigned msb = 63;
+        while (!(v >> msb)) msb--;
+        return (msb - 2) * SUB + static_cast<unsigned>((v >> (msb - 3)) & (SUB - 1));
+    }
+    // ½磬ڹλ
+    static uint64_t floor_of(unsigned k) {
+        if (k < SUB) return k;
+        unsigned msb = k / SUB + 2;
+        return (uint64_t(1) << msb) | (uint64_t(k % SUB) << (msb - 3));
+    }
+
+    void add(uint64_t v) {
+        n++;
+        sum += v;
+        lo = v < lo ? v : lo;
+        hi = v > hi ? v : hi;
+        b[bucket(v)]++;
+    }
+    void merge(const hist& o) {
+        n += o.n;
+        sum += o.sum;
+        lo = o.lo < lo ? o.lo : lo;
+        hi = o.hi > hi ? o.hi : hi;
+        for (int k = 0; k < BUCKETS; k++) b[k] += o.b[k];
+    }
+    uint64_t quantile(double q) const {
+        if (!n) return 0;
+        uint64_t want = static_cast<uint64_t>(q * static_cast<double>(n - 1)) + 1, seen = 0;
+        for (int k = 0; k < BUCKETS; k++) {
+            seen += b[k];
+            if (seen >= want) return std::min(std::max(floor_of(k), lo), hi);
+        }
+        return hi;
+    }
+};
+
+struct event {
+    uint32_t site;
+    uint64_t t0, t1;                    // Խ
+};
+
+struct thread_buf {
+    uint32_t              tid;
+    std::vector<event>    events;
+    uint64_t              dropped;
+    std::vector<int64_t>  counts;       //  site 
+    std::vector<hist*>    hists;        //  site ţõʱŷ
+
+    hist& h(uint32_t site) {
+        if (site >= hists.size()) hists.resize(site + 1, 0);
+        if (!hists[site]) hists[site] = new hist();
+        return *hists[site];
+    }
+};
+
+struct site_info {
+    std::string name;
+    site_kind   kind;
+};
+
+typedef std::chrono::steady_clock clock;
+
+void export_all();
+
+// ȫֵǼǱֻڵǼ siteǼ̺߳͵ʱⲻatexit ʱԿ
+struct registry {
+    std::mutex               mu;
+    std::vector<site_info>   sites;
+    std::vector<thread_buf*> threads;
+    clock::time_point        start;
+
+    registry() : start(clock::now()) { std::atexit(export_all); }
+
+    static registry& get() {
+        static registry* r = new registry();
+        return *r;
+    }
+};
+
+inline uint64_t now_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - registry::get().start).count());
+}
+
+inline uint32_t add_site(const char* name, site_kind kind) {
+    registry& r = registry::get();
+    std::lock_guard<std::mutex> lk(r.mu);
+    r.sites.push_back(site_info());
+    r.sites.back().name = name;
+    r.sites.back().kind = kind;
+    return static_cast<uint32_t>(r.sites.size() - 1);
+}
+
+inline thread_buf& local() {
+    static thread_local thread_buf* tb = 0;
+    if (!tb) {
+        registry& r = registry::get();
+        tb = new thread_buf();
+        tb->dropped = 0;
+        tb->events.reserve(1 << 12);
+        std::lock_guard<std::mutex> lk(r.mu);
+        tb->tid = static_cast<uint32_t>(r.threads.size() + 1);
+        r.threads.push_back(tb);
+    }
+    return *tb;
+}
+
+// ÿ׮һ̬״ξʱǼǲõ
+struct site {
+    uint32_t id;
+    site(const char* name, site_kind kind) : id(add_site(name, kind)) {}
+};
+
+class scope {
+public:
+    explicit scope(const site& s) : site_(s.id), t0_(now_ns()) {}
+    ~scope() {
+        uint64_t t1 = now_ns();
+        thread_buf& tb = local();
+        if (tb.events.size() < TRACE_MAX_EVENTS) {
+            event e = {site_, t0_, t1};
+            tb.events.push_back(e);
+        } else {
+            tb.dropped++;
+        }
+        tb.h(site_).add(t1 - t0_);
+    }
+
+private:
+    scope(const scope&);
+    scope& operator=(const scope&);
+    uint32_t site_;
+    uint64_t t0_;
+};
+
+inline void count(const site& s, int64_t d) {
+    thread_buf& tb = local();
+    if (s.id >= tb.counts.size()) tb.counts.resize(s.id + 1, 0);
+    tb.counts[s.id] += d;
+}
+
+inline void sample(const site& s, uint64_t v) {
+    local().h(s.id).add(v);
+}
+
+inline std::string json_escape(const std::string& s) {
+    std::string o;
+    for (size_t i = 0; i < s.size(); i++) {
+        char c = s[i];
+        if (c == '"' || c == '\\') o += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) o += c;
+    }
+    return o;
+}
+
+inline std::string us(uint64_t ns) {
+    char tmp[32];
+    std::snprintf(tmp, sizeof(tmp), "%.3f", static_cast<double>(ns) / 1000.0);
+    return tmp;
+}
+
+inline void write_trace(registry& r, const char* path) {
+    FILE* f = std::fopen(path, "wb");
+    if (!f) {
+        std::fprintf(stderr, "trace: cannot write %s\n", path);
+        return;
+    }
+    std::string s = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    uint64_t end = now_ns();
+    for (size_t t = 0; t < r.threads.size(); t++) {
+        thread_buf& tb = *r.threads[t];
+        std::string tid = std::to_string(tb.tid);
+        s += first ? "\n" : ",\n";
+        first = false;
+        s += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":\"thread " + tid + "\"}}";
+        for (size_t i = 0; i < tb.events.size(); i++) {
+            const event& e = tb.events[i];
+            s += ",\n{\"name\":\"" + json_escape(r.sites[e.site].name) + "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid +
+                 ",\"ts\":" + us(e.t0) + ",\"dur\":" + us(e.t1 - e.t0) + "}";
+            if (s.size() > (1u << 20)) {
+                std::fwrite(s.data(), 1, s.size(), f);
+                s.clear();
+            }
+        }
+        // ֵֻΪһ Counter ¼ĩβ
+        for (size_t k = 0; k < tb.counts.size(); k++)
+            if (tb.counts[k])
+                s += ",\n{\"name\":\"" + json_escape(r.sites[k].name) + "\",\"ph\":\"C\",\"pid\":1,\"tid\":" + tid +
+                     ",\"ts\":" + us(end) + ",\"args\":{\"value\":" + std::to_string(tb.counts[k]) + "}}";
+    }
+    s += "\n]}\n";
+    std::fwrite(s.data(), 1, s.size(), f);
+    std::fclose(f);
+}
+
+inline void print_summary(registry& r) {
+    std::string s = "\n";
+    char tmp[256];
+    std::snprintf(tmp, sizeof(tmp), "%-28s %10s %12s %10s %10s %10s %10s\n", "scope", "count", "total ms", "mean us",
+                  "p50 us", "p99 us", "max us");
+    s += tmp;
+    uint64_t dropped = 0;
+    for (size_t k = 0; k < r.sites.size(); k++) {
+        hist h;
+        int64_t c = 0;
+        for (size_t t = 0; t < r.threads.size(); t++) {
+            thread_buf& tb = *r.threads[t];
+            if (k < tb.hists.size() && tb.hists[k]) h.merge(*tb.hists[k]);
+            if (k < tb.counts.size()) c += tb.counts[k];
+            if (k == 0) dropped += tb.dropped;
+        }
+        const char* name = r.sites[k].name.c_str();
+        if (r.sites[k].kind == SITE_SCOPE && h.n) {
+            std::snprintf(tmp, sizeof(tmp), "%-28s %10llu %12.3f %10.3f %10.3f %10.3f %10.3f\n", name,
+                          static_cast<unsigned long long>(h.n), h.sum / 1e6, h.sum / 1e3 / h.n, h.quantile(0.5) / 1e3,
+                          h.quantile(0.99) / 1e3, h.hi / 1e3);
+            s += tmp;
+        } else if (r.sites[k].kind == SITE_COUNT) {
+            std::snprintf(tmp, sizeof(tmp), "%-28s %10lld  (counter)\n", name, static_cast<long long>(c));
+            s += tmp;
+        } else if (r.sites[k].kind == SITE_HIST && h.n) {
+            std::snprintf(tmp, sizeof(tmp), "%-28s %10llu  min %llu  p50 %llu  p99 %llu  max %llu  mean %.2f\n", name,
+                          static_cast<unsigned long long>(h.n), static_cast<unsigned long long>(h.lo),
+                          static_cast<unsigned long long>(h.quantile(0.5)),
+                          static_cast<unsigned long long>(h.quantile(0.99)), static_cast<unsigned long long>(h.hi),
+                          static_cast<double>(h.sum) / h.n);
+            s += tmp;
+        }
+    }
+    if (dropped) s += "(" + std::to_string(dropped) + " events over TRACE_MAX_EVENTS kept in summary only)\n";
+    std::fwrite(s.data(), 1, s.size(), stderr);
+}
+
+inline void export_all() {
+    registry& r = registry::get();
+    std::lock_guard<std::mutex> lk(r.mu);
+    const char* path = std::getenv("TRACE_FILE");
+    if (!path) path = "trace.json";
+    if (*path) write_trace(r, path);
+    const char* sum = std::getenv("TRACE_SUMMARY");
+    if (!sum || std::strcmp(sum, "0") != 0) print_summary(r);
+}
+
+} // namespace trace_detail
+
+#define TRACE_CAT2(a, b) a##b
+#define TRACE_CAT(a, b) TRACE_CAT2(a, b)
+#define TRACE_SCOPE(name)                                                                              \
+    static const trace_detail::site TRACE_CAT(trace_site_, __LINE__)(name, trace_detail::SITE_SCOPE); \
+    trace_detail::scope TRACE_CAT(trace_scope_, __LINE__)(TRACE_CAT(trace_site_, __LINE__))
+#define TRACE_COUNT(name, n)                                                                       \
+    do {                                                                                           \
+        static const trace_detail::site trace_site_(name, trace_detail::SITE_COUNT);               \
+        trace_detail::count(trace_site_, static_cast<int64_t>(n));                                 \
+    } while (0)
+#define TRACE_HIST(name, v)                                                                        \
+    do {                                                                                           \
+        static const trace_detail::site trace_site_(name, trace_detail::SITE_HIST);                \
+        trace_detail::sample(trace_site_, static_cast<uint64_t>(v));                               \
+    } while (0)
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_COUNT(name, n) ((void)0)
+#define TRACE_HIST(name, v) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,155 @@
+/*
+  ûͷļ̶С߳̿ͬʱд
+    - ÿ 16 ֽڣcheck = key ^ data  data  64 λֱַԭӶдHyatt 򷨣
+      д˺ѵʱ check Բϣδдõ
+    - 4 һͰһͰһУдʱͬ key ֱӸǣ滻һʣС
+    - data д 32 λֵ16 λϢ߷8 λʣȺ 8 λ
+  new_search() ѴһһµԿУᱻ滻
+  ̽⡢Сд롢ڵߴ tt_counters 
+  ÿ߳һݣټ߳ͬһСoccupancy() ɨֻڱʱá
+*/
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+struct tt_hit {
+    uint32_t value;                     // Զ壨 float λģʽ
+    uint16_t aux;
+    uint8_t  depth;
+};
+
+// һ̵߳ļ
+struct tt_counters {
+    uint64_t probes, hits, stores, overwrites;
+
+    tt_counters() : probes(0), hits(0), stores(0), overwrites(0) {}
+    tt_counters& operator+=(const tt_counters& o) {
+        probes += o.probes;
+        hits += o.hits;
+        stores += o.stores;
+        overwrites += o.overwrites;
+        return *this;
+    }
+};
+
+struct tt_stats {
+    uint64_t probes, hits, stores, overwrites;
+    size_t   entries, bytes;
+};
+
+class TranspositionTable {
+public:
+    enum { WAYS = 4 };
+
+    // bytes ΪĴСޣȡ 2 ݸͰ 1 
+    explicit TranspositionTable(size_t bytes = size_t(16) << 20) : gen_(1) {
+        size_t n = 1;
+        while (n * 2 * sizeof(bucket) <= bytes) n *= 2;
+        mask_ = n - 1;
+        buckets_.reset(new bucket[n]);
+        clear();
+    }
+
+    void clear() {
+        for (size_t i = 0; i <= mask_; i++)
+            for (int w = 0; w < WAYS; w++) {
+                buckets_[i].e[w].check.store(0, std::memory_order_relaxed);
+                buckets_[i].e[w].data.store(0, std::memory_order_relaxed);
+            }
+    }
+
+    void new_search() { gen_ = static_cast<uint8_t>(gen_ + 1 ? gen_ + 1 : 1); }
+
+    bool probe(uint64_t key, tt_hit& out, tt_counters& cnt) {
+        cnt.probes++;
+        bucket& b = buckets_[key & mask_];
+        for (int w = 0; w < WAYS; w++) {
+            uint64_t d = b.e[w].data.load(std::memory_order_relaxed);
+            uint64_t c = b.e[w].check.load(std::memory_order_relaxed);
+            if ((c ^ d) == key && (c | d)) {
+                out = unpack(d);
+                cnt.hits++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void store(uint64_t key, uint32_t value, uint16_t aux, uint8_t depth, tt_counters& cnt) {
+        cnt.stores++;
+        bucket& b = buckets_[key & mask_];
+        int victim = 0, worst = 1 << 30;
+        for (int w = 0; w < WAYS; w++) {
+            uint64_t d = b.e[w].data.load(std::memory_order_relaxed);
+            uint64_t c = b.e[w].check.load(std::memory_order_relaxed);
+            if (!(c | d) || (c ^ d) == key) {       // λͬһ
+                victim = w;
+                worst = -1;
+                break;
+            }
+            // ɴȻͬʣСȻ
+            uint8_t g = static_cast<uint8_t>(d);
+            int score = (g == gen_ ? 256 : 0) + static_cast<int>((d >> 8) & 0xFF);
+            if (score < worst) {
+                worst = score;
+                victim = w;
+            }
+        }
+        if (worst >= 0) cnt.overwrites++;
+        uint64_t d = static_cast<uint64_t>(value) << 32 | static_cast<uint64_t>(aux) << 16 |
+                     static_cast<uint64_t>(depth) << 8 | gen_;
+        b.e[victim].data.store(d, std::memory_order_relaxed);
+        b.e[victim].check.store(key ^ d, std::memory_order_relaxed);
+    }
+
+    // ĴСϵ߻ܺõļ
+    tt_stats stats(const tt_counters& c) const {
+        tt_stats s;
+        s.probes = c.probes;
+        s.hits = c.hits;
+        s.stores = c.stores;
+        s.overwrites = c.overwrites;
+        s.entries = (mask_ + 1) * WAYS;
+        s.bytes = (mask_ + 1) * sizeof(bucket);
+        return s;
+    }
+
+    // ռռɨ
+    double occupancy() const {
+        size_t used = 0;
+        for (size_t i = 0; i <= mask_; i++)
+            for (int w = 0; w < WAYS; w++)
+                used += (buckets_[i].e[w].check.load(std::memory_order_relaxed) |
+                         buckets_[i].e[w].data.load(std::memory_order_relaxed)) != 0;
+        return static_cast<double>(used) / static_cast<double>((mask_ + 1) * WAYS);
+    }
+
+private:
+    TranspositionTable(const TranspositionTable&);
+    TranspositionTable& operator=(const TranspositionTable&);
+
+    struct entry {
+        std::atomic<uint64_t> check, data;
+    };
+    struct alignas(64) bucket {
+        entry e[WAYS];
+    };
+
+    static tt_hit unpack(uint64_t d) {
+        tt_hit h;
+        h.value = static_cast<uint32_t>(d >> 32);
+        h.aux = static_cast<uint16_t>(d >> 16);
+        h.depth = static_cast<uint8_t>(d >> 8);
+        return h;
+    }
+
+    std::unique_ptr<bucket[]> buckets_;
+    size_t                    mask_;
+    uint8_t                   gen_;
+};
+
+#endif
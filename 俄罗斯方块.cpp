@@ -1,9 +1,19 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <windows.h>
 #include <vector>
-#include <mmsystem.h>
+#include "bench.h"
+#include "out_sink.h"
+#include "piece_queue.h"
+#include "terminal.h"
+#include "tetris_bot.h"
+#include "tetris_game.h"
+#include "tetris_server.h"
+#include "trace.h"
 
-#pragma comment(lib, "winmm.lib")
 using namespace std;
 
 #define GameW 10
@@ -17,37 +27,36 @@ struct Point
      int _x, _y;
 };
 
-HANDLE g_hOutput = GetStdHandle(STD_OUTPUT_HANDLE);
-HANDLE g_hInput   = GetStdHandle(STD_INPUT_HANDLE);
-
 Point g_ptCursor(0,0);
-BOOL isChecking = FALSE;
-BOOL g_bGameOver = FALSE;
+bool isChecking = false;
+bool g_bGameOver = false;
 int g_nGameBack[GameH][GameW], Case;
 int nowKeyInfo = -1;
 int g_nDiff = 1;
 int g_nLife = 0;                        //Ϸֵ 
 int g_nScore = 0;
+OutSink g_out;                          // Present() һд
+PieceQueue g_pieces;                    //ֵķУpeek(0) Ԥеһ
 
-void SetCursor(COORD cd)
-{
-     SetConsoleCursorPosition(g_hOutput, cd);
+//µĻд̨ȴǰ
+void Present() {
+     g_out.flush();
 }
+
+// ANSI жλ꣬Ҫַһ壬εÿ̨ API
 void SetCursor(int x, int y){
-     COORD cd = {x, y};
-     SetCursor(cd);
+     g_out << "\033[" << y + 1 << ';' << x + 1 << 'H';
 }
 void SetBlockCursor(int x, int y){
-     COORD cd = {2*x + 2, y + 1};
-     SetCursor(cd);
+     SetCursor(2*x + 2, y + 1);
 }
 
-void SetBack(int x, int y, BOOL bk) {
+void SetBack(int x, int y, bool bk) {
      SetBlockCursor(x, y);
      if (bk) 
-         printf("%s", "");
+         g_out << "";
      else
-         printf("   ");
+         g_out << "   ";
 
 }
 
@@ -59,14 +68,14 @@ struct xBlock {
 public:
      int len;
      int nowRotateID;
-     BOOL mask[4][4][4];
+     bool mask[4][4][4];
      static vector <xBlock> List;
 
      xBlock() { len = 0; }
-     xBlock(int l, char *str) {
+     xBlock(int l, const char *str) {
          int i, j, k;
          len = l;
-         memset(mask, FALSE, sizeof(mask));
+         memset(mask, false, sizeof(mask));
          for(i = 0; i < l; i++) {
              for(j = 0; j < l; j++) {
                  mask[0][i][j] = str[i*l + j] - '0';
@@ -88,7 +97,7 @@ public:
              nowRotateID = 0;
      }
 
-     BOOL getUnit(int x, int y, int roID) {
+     bool getUnit(int x, int y, int roID) {
          if (roID == -1) {
              roID = nowRotateID;
          }
@@ -104,8 +113,8 @@ public:
      int ID;
      xBlock bk;
 
-     void reset(xBlock *pbk) {
-         bk = *pbk;
+     void reset(const xBlock &next) {
+         bk = next;
 
          x = 4, y = 0;
          ID = ++ Case;
@@ -115,33 +124,33 @@ public:
              lifeDown();
          }
          draw();
-        
-         *pbk = xBlock::List[rand() % xBlock::List.size()];
      }
     
      void lifeDown() {
          int i, j;
          for(i = 0; i < GameH; i++) {
              for(j = 0; j < GameW; j++) {
-                 SetBack(j, i, TRUE);
-                 Sleep(10);
+                 SetBack(j, i, true);
+                 Present();
+                 term_sleep_ms(10);
              }
          }
          if(g_nLife) {
              g_nLife --;
              for(i = g_nLife; i < 6; i++) {
                  SetCursor(CtrlLeft + i, 15);
-                 printf("%c", ' ');
+                 g_out << ' ';
              }
              for(i = GameH-1; i >= 0; i--) {
                  for(j = GameW-1; j >= 0; j--) {
-                     SetBack(j, i, FALSE);
-                     Sleep(10);
+                     SetBack(j, i, false);
+                     Present();
+                     term_sleep_ms(10);
                      g_nGameBack[i][j] = 0;
                  }
              }
          }else {
-             g_bGameOver = TRUE;
+             g_bGameOver = true;
          }
      }
 
@@ -151,7 +160,7 @@ public:
              for(j = 0; j < bk.len; j++) {
         if (bk.getUnit(j, i, -1)) {
                      if(!Out(j+x, i+y) && g_nGameBack[i+y][j+x]) {
-                         SetBack(j+x, i+y, FALSE);
+                         SetBack(j+x, i+y, false);
                          g_nGameBack[i+y][j+x] = 0;
                      }
                  }
@@ -164,7 +173,7 @@ public:
              for(j = 0; j < bk.len; j++) {
                  if (bk.getUnit(j, i, -1)) {
                      if(!Out(j+x, i+y) && !g_nGameBack[i+y][j+x]) {
-                         SetBack(j+x, i+y, TRUE);
+                         SetBack(j+x, i+y, true);
                          g_nGameBack[i+y][j+x]   = ID;
                      }
                  }
@@ -177,10 +186,10 @@ public:
              for(j = 0; j < 4; j++) {
                  SetCursor(x + 2*j, y + i);
                  if (bk.getUnit(j, i, -1)) {    
-                     printf("%s", "");
+                     g_out << "";
 
                  }else 
-                     printf("   ");
+                     g_out << "   ";
              }
          }
      }
@@ -191,13 +200,13 @@ public:
                  if (bk.getUnit(j, i, roID)) {
                      Point ptPos(j + x + dx, i + y + dy);
                      if(Out(ptPos._x, ptPos._y)
-                     || g_nGameBack[ptPos._y][ptPos._x] && ID != g_nGameBack[ptPos._y][ptPos._x]) {
-                         return TRUE;
+                     || (g_nGameBack[ptPos._y][ptPos._x] && ID != g_nGameBack[ptPos._y][ptPos._x])) {
+                         return true;
                      }
                  }
              }
          }
-         return FALSE;
+         return false;
      }
 
      void rotate(int nTimes = 1) {
@@ -205,29 +214,48 @@ public:
          if(collide(0, 0, nextro)) {
              return ;
          }
-         Beep(12000, 50);
+         Present();
+         term_beep(12000, 50);
          erase();
          bk.nowRotateID = nextro;
          draw();
      }
 
-     BOOL changepos(int dx, int dy) {
+     bool changepos(int dx, int dy) {
+         TRACE_SCOPE("tetris/changepos");
          if(collide(dx, dy)) {
-             return FALSE;
+             return false;
          }
          erase();
          x += dx;
          y += dy;
          draw();
-         return TRUE;
+         return true;
      }
 };
 
-void GameInit() {
-     CONSOLE_CURSOR_INFO cursor_info;
-     cursor_info.bVisible = FALSE;
-     cursor_info.dwSize    = 100;
-     SetConsoleCursorInfo(g_hOutput, &cursor_info);
+//AI õ״ xBlock::List һһӦ
+vector <bot_piece> BotPieces() {
+     vector <bot_piece> v;
+     for(int k = 0; k < (int)xBlock::List.size(); k++) {
+         v.push_back(bot_piece_from_mask(xBlock::List[k].len, xBlock::List[k].mask));
+     }
+     return v;
+}
+
+//ǰĸӶ AI 
+void LoadBotBoard(bot_board &b, int ID) {
+     int cells[GameH][GameW];
+     for(int i = 0; i < GameH; i++) {
+         for(int j = 0; j < GameW; j++) {
+             cells[i][j] = g_nGameBack[i][j] && g_nGameBack[i][j] != ID;
+         }
+     }
+     b.load(cells);
+}
+
+//ַ״
+void LoadBlocks() {
      xBlock::List.push_back(xBlock(3, "010111000"));
      xBlock::List.push_back(xBlock(3, "110110000"));
      xBlock::List.push_back(xBlock(3, "111001000"));
@@ -237,48 +265,55 @@ void GameInit() {
      xBlock::List.push_back(xBlock(4, "1000100010001000"));
 }
 
+void GameInit() {
+     term_init();                       //ʱɶԣ˳ʱԶԭ
+     term_cursor(false);
+     term_clear();
+     LoadBlocks();
+}
+
 void DrawFrame(int x, int y, int nWidth, int nHeight) {
      int i;
      for(i = 0; i < nWidth; i++) {
          SetCursor(x + 2*i + 2, y);
-         printf("%s", "һ");
+         g_out << "һ";
          SetCursor(x + 2*i + 2, y + nHeight+1);
-         printf("%s", "");
+         g_out << "";
      }
      for(i = 0; i < nHeight; i++) {
          SetCursor(x, y + i + 1);
-         printf("%s", "");
+         g_out << "";
          SetCursor(x + nWidth*2+2, y + i + 1);
-         printf("%s", "");
+         g_out << "";
      }        
      SetCursor(x, y);
-     printf("%s", "");    
+     g_out << "";    
      SetCursor(x, y + nHeight+1);
-     printf("%s", "");
+     g_out << "";
      SetCursor(x + nWidth*2+2, y);
-     printf("%s", "");    
+     g_out << "";    
      SetCursor(x + nWidth*2+2, y + nHeight+1);
-     printf("%s", "");
+     g_out << "";
 }
 
 void MissionInit() {
-     memset(g_nGameBack, FALSE, sizeof(g_nGameBack));
+     memset(g_nGameBack, false, sizeof(g_nGameBack));
      Case = 1;
-     int i;
      DrawFrame(0, 0, GameW, GameH);
      DrawFrame(GameW*2+4, 0, 4, GameH);
      SetCursor(CtrlLeft, 2);
-     printf("Next");
+     g_out << "Next";
      SetCursor(CtrlLeft, 8);
-     printf("Score");
+     g_out << "Score";
      SetCursor(CtrlLeft, 9);
-     printf("%d", g_nScore);
+     g_out << g_nScore;
 }
 
-void Check() {
-     isChecking = TRUE;
-     int i, j, k;
-     vector <int> line;
+//ҳУϵ·Ž line
+void FindFullLines(vector <int> &line) {
+     TRACE_SCOPE("tetris/find_lines");
+     int i, j;
+     line.clear();
      for(i = 0; i < GameH; i++) {
          for(j = 0; j < GameW; j++) {
              if(!g_nGameBack[i][j])
@@ -288,40 +323,61 @@ void Check() {
              line.push_back(i);
          }
      }
+}
+
+// line еУÿʣµĸ䵽ײ
+void CollapseLines(const vector <int> &line) {
+     TRACE_SCOPE("tetris/collapse");
+     int i, j, k;
+     for(i = 0; i < (int)line.size(); i++) {
+         for(j = 0; j < GameW; j++) {
+             g_nGameBack[line[i]][j] = 0;
+         }
+     }
+
+     for(i = 0; i < GameW; i++) {
+
+         int next = GameH-1;
+         for(j = GameH-1; j >= 0; j--) {
+             for(k = next; k >= 0; k--) {
+                 if(g_nGameBack[k][i]) 
+                     break;
+             }
+             next = k - 1;
+             g_nGameBack[j][i] = (k >= 0);
+         }
+     }
+}
+
+// Check ĺʱ˸ĵȴ㲿ּ find_linescollapse 
+void Check() {
+     TRACE_SCOPE("tetris/check");
+     isChecking = true;
+     int i, j;
+     vector <int> line;
+     FindFullLines(line);
+     TRACE_HIST("tetris/lines", line.size());
      if(line.size()) {
          int nCount = 7;
          while(nCount --) {
-             for(i = 0; i < line.size(); i++) {
+             for(i = 0; i < (int)line.size(); i++) {
                  for(j = 0; j < GameW; j++) {
                      SetBack(j, line[i], nCount&1);
                  }
              }
-             Sleep(70);
-         }
-         for(i = 0; i < line.size(); i++) {
-             for(j = 0; j < GameW; j++) {
-                 g_nGameBack[line[i]][j] = 0;
-             }
+             Present();
+             term_sleep_ms(70);
          }
-
+         CollapseLines(line);
          for(i = 0; i < GameW; i++) {
-
-             int next = GameH-1;
              for(j = GameH-1; j >= 0; j--) {
-                 for(k = next; k >= 0; k--) {
-                     if(g_nGameBack[k][i]) 
-                         break;
-                 }
-                 next = k - 1;
-                 BOOL is = (k >= 0);
-                 SetBack(i, j, is);
-                 g_nGameBack[j][i] = is;
+                 SetBack(i, j, g_nGameBack[j][i] != 0);
              }
          }
 
          g_nScore += 2*line.size()-1;
          SetCursor(CtrlLeft, 12);
-         printf("%d", g_nScore);
+         g_out << g_nScore;
 
          if( g_nScore >= g_nDiff * g_nDiff * 10) {
              if(g_nDiff <= 6)
@@ -333,67 +389,527 @@ void Check() {
          }
      }
 
-     isChecking = FALSE;
+     isChecking = false;
 }
-int main() {
+
+int bench(int argc, char *argv[]);
+
+int main(int argc, char *argv[]) {
+     //˹ --bench [--format=json ...]ײУնˣ bench.h
+     if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+         return bench(argc, argv);
+     //˹ [--bag | --classic] [--seed=N]ԣĬÿζӣĬȡǰʱ䣩
+     //  [--auto[=D]] [--threads=N] AI £ǰԤ D Ĭ 3ڵָ N ߳
+     //˹ --server [--listen=ַ] [--threads=N] [--max-games=N] [--duration=] [--report-ms=]
+     //  棬 N ߳й֣ܶͻ˾ TCP/Unix ׽루 tetris_server.h Linux
+     //˹ --load=N [--connect=ַ] [--threads=N] [--key-ms=] [--duration=] N ͻѹ
+     piece_policy policy = PIECE_CLASSIC;
+     uint64_t seed = (uint64_t)chrono::high_resolution_clock::now().time_since_epoch().count();
+     int nAuto = 0;
+     unsigned nThreads = 0;
+     bool bServer = false;
+     unsigned nLoad = 0, nMaxGames = 10000, nReportMs = 1000, nKeyMs = 200;
+     double fDuration = 0;
+     string sListen, sConnect;
+     for (int a = 1; a < argc; a++) {
+         if (strcmp(argv[a], "--bag") == 0)
+             policy = PIECE_BAG;
+         else if (strcmp(argv[a], "--classic") == 0)
+             policy = PIECE_CLASSIC;
+         else if (strncmp(argv[a], "--seed=", 7) == 0)
+             seed = strtoull(argv[a] + 7, 0, 0);
+         else if (strcmp(argv[a], "--auto") == 0)
+             nAuto = 3;
+         else if (strncmp(argv[a], "--auto=", 7) == 0)
+             nAuto = atoi(argv[a] + 7);
+         else if (strncmp(argv[a], "--threads=", 10) == 0)
+             nThreads = (unsigned)atoi(argv[a] + 10);
+         else if (strcmp(argv[a], "--server") == 0)
+             bServer = true;
+         else if (strncmp(argv[a], "--listen=", 9) == 0)
+             sListen = argv[a] + 9;
+         else if (strncmp(argv[a], "--max-games=", 12) == 0)
+             nMaxGames = (unsigned)atoi(argv[a] + 12);
+         else if (strncmp(argv[a], "--report-ms=", 12) == 0)
+             nReportMs = (unsigned)atoi(argv[a] + 12);
+         else if (strncmp(argv[a], "--duration=", 11) == 0)
+             fDuration = atof(argv[a] + 11);
+         else if (strncmp(argv[a], "--load=", 7) == 0)
+             nLoad = (unsigned)atoi(argv[a] + 7);
+         else if (strncmp(argv[a], "--connect=", 10) == 0)
+             sConnect = argv[a] + 10;
+         else if (strncmp(argv[a], "--key-ms=", 9) == 0)
+             nKeyMs = (unsigned)atoi(argv[a] + 9);
+     }
+     if (bServer || nLoad) {
+#if defined(__linux__)
+         if (nLoad) {
+             load_config lc = {sConnect, nLoad, nThreads, nKeyMs, fDuration};
+             return tetris_load_run(lc);
+         }
+         LoadBlocks();
+         server_config sc = {sListen, nThreads, nMaxGames, policy, seed, nReportMs, fDuration};
+         return tetris_server_run(BotPieces(), sc);
+#else
+         g_out << "ѹģʽҪ Linuxepoll\n";
+         Present();
+         return 1;
+#endif
+     }
      Block* obj = new Block();
      Block* buf = new Block();
     
 
-     BOOL bCreateNew = FALSE;
-     int nTimer = GetTickCount();
-     int LastKeyDownTime = GetTickCount();
+     bool bCreateNew = false;
+     uint64_t nTimer = term_now_ms();
+     uint64_t LastKeyDownTime = term_now_ms();
 
 
      GameInit();
      MissionInit();
     
-     buf->bk = xBlock::List[rand() % xBlock::List.size()];
+     g_pieces.reset((int)xBlock::List.size(), policy, seed);
+     if (nAuto < 0)
+         nAuto = 0;
+     if (nAuto > (int)g_pieces.lookahead() + 1)
+         nAuto = (int)g_pieces.lookahead() + 1;
+     TetrisBot *bot = nAuto ? new TetrisBot(BotPieces()) : 0;
+     bot_move target = {0, 0, 0, 0, 0};
+     int nPiece = 0;
      while(1) {
          if(!bCreateNew) {
-             bCreateNew = TRUE;
-             obj->reset(&buf->bk);
+             bCreateNew = true;
+             nPiece = g_pieces.pop();
+             obj->reset(xBlock::List[nPiece]);
              if(g_bGameOver)
                  break;
+             buf->bk = xBlock::List[g_pieces.peek()];
              buf->draw(CtrlLeft - 1, 4);
+             if (bot) {
+                 int seq[BOT_MAX_PLY];
+                 seq[0] = nPiece;
+                 for (int k = 1; k < nAuto; k++)
+                     seq[k] = g_pieces.peek(k - 1);
+                 bot_board b;
+                 LoadBotBoard(b, obj->ID);
+                 bot_move from = {obj->bk.nowRotateID, obj->x, obj->y, 0, 0};
+                 target = bot->best(b, seq, nAuto, from, nThreads ? nThreads : 1);
+             }
          }
-         if (GetTickCount() - nTimer >= 1000 / g_nDiff) {
-             nTimer = GetTickCount();
+         if (term_now_ms() - nTimer >= (uint64_t)(1000 / g_nDiff)) {
+             nTimer = term_now_ms();
              if (!obj->collide(0, 1))
                  obj->changepos(0, 1);
              else {
                  Check();
-                 bCreateNew = FALSE;
+                 bCreateNew = false;
              }
          }
-         if (GetTickCount() - LastKeyDownTime >= 100) {
-             if(FALSE == isChecking) {
-                 LastKeyDownTime = GetTickCount();
-                 if (GetAsyncKeyState(VK_UP)) {
+         if (term_now_ms() - LastKeyDownTime >= 100) {
+             if(false == isChecking) {
+                 LastKeyDownTime = term_now_ms();
+                 unsigned keys = term_poll_keys();
+                 //AI ÿһǰλĿ·ȡһֻһҪȥλ
+                 if (bot) {
+                     keys = 0;
+                     bot_board b;
+                     LoadBotBoard(b, obj->ID);
+                     bot_move cur = {obj->bk.nowRotateID, obj->x, obj->y, 0, 0};
+                     switch (bot->next_step(b, nPiece, cur, target)) {
+                     case BOT_STEP_ROTATE: keys = KEY_UP; break;
+                     case BOT_STEP_LEFT: keys = KEY_LEFT; break;
+                     case BOT_STEP_RIGHT: keys = KEY_RIGHT; break;
+                     case BOT_STEP_STAY: break;
+                     default: obj->changepos(0, 1); break;
+                     }
+                 }
+                 if (keys & KEY_UP) {
                      obj->rotate();
                  }
-                 if (GetAsyncKeyState(VK_LEFT)) {
+                 if (keys & KEY_LEFT) {
                      obj->changepos(-1, 0);
                  }
-                 if (GetAsyncKeyState(VK_RIGHT)) {
+                 if (keys & KEY_RIGHT) {
                      obj->changepos(1, 0);
                  }
-                 if (GetAsyncKeyState(VK_DOWN)) {
-                     if( FALSE == obj->changepos(0, 2) )
+                 if (keys & KEY_DOWN) {
+                     if( false == obj->changepos(0, 2) )
                          obj->changepos(0, 1);
                  }
              }
          }
+         Present();                     //ֵиĶһд
      }
      SetCursor(8, 10);
-     printf("Game Over");
+     g_out << "Game Over";
 
      SetCursor(0, GameH+3);
-     printf("ESC˳Ϸ");
+     g_out << "ESC˳Ϸ";
+     Present();
 
      while(1) {
-         if (GetAsyncKeyState(VK_ESCAPE))
+         if (term_poll_keys() & KEY_ESC)
              break;
+         term_sleep_ms(10);
      }
+     SetCursor(0, GameH+4);
+     if (bot) {
+         tt_stats st = bot->table_stats();
+         g_out << "AI " << bot->searches() << " Σչ " << bot->nodes() << " 棬û ";
+         g_out.fixed(st.probes ? 100.0 * st.hits / st.probes : 0.0, 1);
+         g_out << "%" << (uint64_t)st.entries << "  / " << (uint64_t)(st.bytes >> 20) << " MiBռ ";
+         g_out.fixed(100.0 * bot->table().occupancy(), 1);
+         g_out << "%\n";
+         delete bot;
+     }
+     Present();
+     term_restore();
      return 0;
 }
+
+//棺°벿Լɸп飬뵱ǰ鲻ͬӹ̶
+static void RandomBoard(bench_rng &rng, int board[GameH][GameW], int fullLines) {
+     int i, j;
+     memset(board, 0, sizeof(int) * GameH * GameW);
+     for(i = GameH/2; i < GameH; i++) {
+         for(j = 0; j < GameW; j++) {
+             board[i][j] = rng.range(0, 4) < 3 ? rng.range(2, 1000) : 0;
+         }
+     }
+     for(i = 0; i < fullLines; i++) {
+         int row = rng.range(GameH/2, GameH-1);
+         for(j = 0; j < GameW; j++) {
+             board[row][j] = rng.range(2, 1000);
+         }
+     }
+}
+
+//ĸλãһмϸе룬ͬͬͬ
+static uint64_t PlacementKey(const bot_piece &p, int ro, int x, int y) {
+     uint64_t key = (uint64_t)(y + p.lo[ro]);
+     for(int i = p.lo[ro]; i <= p.hi[ro]; i++) {
+         key |= (uint64_t)p.cells[ro][x + 3][i] << (5 + 10 * (i - p.lo[ro]));
+     }
+     return key;
+}
+
+//̽ģߵͲ棨ѵģÿַȽ
+//  bot_for_each_drop 롰ÿÿһдϷ䡱bot_reach::run  BFS
+//  ȽϵӵļϣزһµĴд cerr
+static int CheckMoveGen(bench_rng &rng, const vector <bot_piece> &pieces, int nBoards) {
+     static bot_reach reach;
+     static const int XS = bot_reach::XS;
+     int bad = 0;
+     for(int n = 0; n < nBoards; n++) {
+         bot_board b;
+         int base = rng.range(0, BOT_H);
+         for(int j = 0; j < BOT_W; j++) {
+             int h = min(BOT_H - 1, max(0, base + rng.range(-3, 3)));
+             for(int i = BOT_H - h; i < BOT_H; i++) {
+                 if (rng.range(0, 9) < 8)
+                     b.row[i] |= (uint16_t)(1u << j);
+             }
+         }
+         b.rehash();
+         for(size_t k = 0; k < pieces.size(); k++) {
+             const bot_piece &p = pieces[k];
+             //ֱ䣺Ϸ£ͬһ״ļֻҪһŵý y >= 0 ķ
+             int minLo[4];
+             for(int ro = 0; ro < 4; ro++) {
+                 minLo[ro] = p.lo[ro];
+                 for(int r = 0; r < 4; r++) {
+                     if (PlacementKey(p, r, -p.left[r], -p.lo[r]) == PlacementKey(p, ro, -p.left[ro], -p.lo[ro]))
+                         minLo[ro] = min(minLo[ro], (int)p.lo[r]);
+                 }
+             }
+             vector <uint64_t> want, got;
+             for(int ro = 0; ro < 4; ro++) {
+                 for(int x = -3; x < BOT_W; x++) {
+                     if (!p.in_range(ro, x))
+                         continue;
+                     for(int y = -p.hi[ro] - 1; ; y++) {
+                         bool stop = false;
+                         for(int i = p.lo[ro]; i <= p.hi[ro]; i++) {
+                             int r = y + 1 + i;
+                             stop |= r >= BOT_H || (r >= 0 && (b.row[r] & p.cells[ro][x + 3][i]));
+                         }
+                         if (stop) {
+                             if (y + p.lo[ro] >= minLo[ro])
+                                 want.push_back(PlacementKey(p, ro, x, y));
+                             break;
+                         }
+                     }
+                 }
+             }
+             bot_for_each_drop(b, p, [&](int ro, int x, int y) { got.push_back(PlacementKey(p, ro, x, y)); });
+             size_t nGot = got.size();
+             sort(want.begin(), want.end());
+             want.erase(unique(want.begin(), want.end()), want.end());
+             sort(got.begin(), got.end());
+             if (got != want || nGot != got.size()) {
+                 cerr << "movegen " << n << " 淽 " << k << " ֱ " << nGot << "  " << want.size() << " \n";
+                 bad++;
+             }
+             // BFS (0, 4, 0) ҡһ˳ʱתһ
+             int ro0 = 0, x0 = 4;
+             if (!b.fits(p, ro0, x0, 0))
+                 continue;
+             vector <char> seen(4 * XS * BOT_H, 0);
+             vector <int> queue(1, (ro0 * XS + x0 + 3) * BOT_H);
+             seen[queue[0]] = 1;
+             want.clear();
+             for(size_t h = 0; h < queue.size(); h++) {
+                 int s = queue[h], ro = s / (XS * BOT_H), x = s / BOT_H % XS - 3, y = s % BOT_H;
+                 if (!b.fits(p, ro, x, y + 1))
+                     want.push_back(PlacementKey(p, ro, x, y));
+                 const int next[4][3] = {{ro, x - 1, y}, {ro, x + 1, y}, {ro, x, y + 1}, {(ro + 1) & 3, x, y}};
+                 for(int d = 0; d < 4; d++) {
+                     int r = next[d][0], nx = next[d][1], ny = next[d][2];
+                     if (nx < -3 || nx >= BOT_W || ny >= BOT_H || !b.fits(p, r, nx, ny))
+                         continue;
+                     int t = (r * XS + nx + 3) * BOT_H + ny;
+                     if (!seen[t]) {
+                         seen[t] = 1;
+                         queue.push_back(t);
+                     }
+                 }
+             }
+             got.clear();
+             int nLand = reach.run(b, p, ro0, x0, 0);
+             for(int i = 0; i < nLand; i++) {
+                 const bot_move &m = reach.landing(i);
+                 got.push_back(PlacementKey(p, m.ro, m.x, m.y));
+             }
+             sort(want.begin(), want.end());
+             want.erase(unique(want.begin(), want.end()), want.end());
+             sort(got.begin(), got.end());
+             if (got != want || nLand != (int)got.size()) {
+                 cerr << "movegen " << n << " 淽 " << k << " ɴ " << nLand << "  BFS " << want.size() << " \n";
+                 bad++;
+             }
+         }
+     }
+     return bad;
+}
+
+int bench(int argc, char *argv[]) {
+     BenchSuite suite("tetris", argc, argv, 2);
+     bench_rng rng(suite.seed());
+     LoadBlocks();
+     int nPiece = (int)xBlock::List.size();
+
+     //ײ⣺ַһλ볯һһ̽
+     static const int N = 1024;
+     vector <Block> blocks(nPiece);
+     for(int k = 0; k < nPiece; k++) {
+         blocks[k].bk = xBlock::List[k];
+         blocks[k].ID = 1;
+     }
+     struct probe { int piece, x, y, dy, ro; };
+     vector <probe> probes(N);
+     for(int i = 0; i < N; i++) {
+         probes[i].piece = rng.range(0, nPiece-1);
+         probes[i].x = rng.range(-1, GameW-2);
+         probes[i].y = rng.range(0, GameH-2);
+         probes[i].dy = rng.range(0, 1);
+         probes[i].ro = rng.range(0, 3);
+     }
+     static int boardCollide[GameH][GameW];
+     RandomBoard(rng, boardCollide, 0);
+
+     //У64 棬 0~4 УصÿεȰ濽 g_nGameBack
+     static const int NB = 64;
+     static int boards[NB][GameH][GameW];
+     for(int b = 0; b < NB; b++) {
+         RandomBoard(rng, boards[b], b % 5);
+     }
+     static int boardEmpty[GameH][GameW];
+     RandomBoard(rng, boardEmpty, 0);
+
+     suite.add("collide", [&](bench_state &st) {
+         memcpy(g_nGameBack, boardCollide, sizeof(g_nGameBack));
+         for(uint64_t i = 0; i < st.iterations(); i++) {
+             const probe &p = probes[i & (N-1)];
+             Block &b = blocks[p.piece];
+             b.x = p.x;
+             b.y = p.y;
+             bench_keep(b.collide(0, p.dy, p.ro));
+         }
+         st.set_items(st.iterations());
+     });
+     suite.add("check/no_lines", [&](bench_state &st) {
+         vector <int> line;
+         line.reserve(GameH);
+         memcpy(g_nGameBack, boardEmpty, sizeof(g_nGameBack));
+         for(uint64_t i = 0; i < st.iterations(); i++) {
+             FindFullLines(line);
+             bench_keep(line.size());
+         }
+         st.set_items(st.iterations());
+     });
+     suite.add("check/clear_lines", [&](bench_state &st) {
+         vector <int> line;
+         line.reserve(GameH);
+         for(uint64_t i = 0; i < st.iterations(); i++) {
+             memcpy(g_nGameBack, boards[i & (NB-1)], sizeof(g_nGameBack));
+             FindFullLines(line);
+             CollapseLines(line);
+             bench_clobber();
+         }
+         st.set_items(st.iterations());
+     });
+     //飺ԭ rand() % n Ա
+     suite.add("pieces/rand_mod", [&](bench_state &st) {
+         for(uint64_t i = 0; i < st.iterations(); i++) {
+             bench_keep(rand() % nPiece);
+         }
+         st.set_items(st.iterations());
+     });
+     suite.add("pieces/classic", [&](bench_state &st) {
+         PieceQueue q(nPiece, PIECE_CLASSIC, suite.seed());
+         for(uint64_t i = 0; i < st.iterations(); i++) {
+             bench_keep(q.pop());
+         }
+         st.set_items(st.iterations());
+     });
+     suite.add("pieces/bag", [&](bench_state &st) {
+         PieceQueue q(nPiece, PIECE_BAG, suite.seed());
+         for(uint64_t i = 0; i < st.iterations(); i++) {
+             bench_keep(q.pop());
+         }
+         st.set_items(st.iterations());
+     });
+     //AI 2 һ֣ NP 뷽Уͬ˳Щ棬
+     //  û޹أֱӱȽϡûڸ֮䱣ʵʶԾһ
+     //  ƻؿͷʱգһµno_tt ȫûΪ
+     vector <bot_piece> pieces = BotPieces();
+     static const int NP = 1024;
+     static const int DEPTH = 4;         //벻Ԥ + 1
+     struct position { bot_board board; int seq[DEPTH]; };
+     vector <position> positions(NP);
+     {
+         TetrisBot bot(pieces, 64);
+         PieceQueue q(nPiece, PIECE_BAG, suite.seed());
+         bot_board b;
+         bot_move spawn = {0, 4, 0, 0, 0};
+         for(int i = 0; i < NP; i++) {
+             position &pos = positions[i];
+             pos.board = b;
+             pos.seq[0] = q.pop();
+             for(int k = 1; k < DEPTH; k++)
+                 pos.seq[k] = q.peek(k - 1);
+             bot_move m = bot.best(b, pos.seq, 2, spawn);
+             if (m.score == BOT_DEAD)
+                 b.clear();
+             else
+                 b.place(pieces[pos.seq[0]], m.ro, m.x, m.y);
+         }
+     }
+     auto bot_case = [&](int depth, size_t ttBytes, unsigned threads) {
+         return [&pieces, &positions, depth, ttBytes, threads](bench_state &st) {
+             TetrisBot bot(pieces, ttBytes);
+             bot_move spawn = {0, 4, 0, 0, 0};
+             uint64_t lines = 0;
+             for(uint64_t i = 0; i < st.iterations(); i++) {
+                 const position &pos = positions[i % NP];
+                 if (i && i % NP == 0)
+                     bot.table().clear();
+                 bot_move m = bot.best(pos.board, pos.seq, depth, spawn, threads);
+                 lines += m.lines;
+             }
+             tt_stats ts = bot.table_stats();
+             st.set_items(bot.nodes());
+             st.counter("hit_rate", ts.probes ? (double)ts.hits / ts.probes : 0);
+             st.counter("nodes_per_move", (double)bot.nodes() / st.iterations());
+             st.counter("overwrites", (double)ts.overwrites);
+             st.counter("tt_bytes", (double)ts.bytes);
+             st.counter("occupancy", bot.table().occupancy());
+             st.counter("lines", (double)lines);
+         };
+     };
+     suite.add("bot/depth2", bot_case(2, size_t(4) << 20, 1));
+     suite.add("bot/depth3", bot_case(3, size_t(4) << 20, 1));
+     suite.add("bot/depth3/no_tt", bot_case(3, 0, 1));
+     suite.add("bot/depth4", bot_case(4, size_t(4) << 20, 1));
+     suite.add("bot/depth4/no_tt", bot_case(4, 0, 1));
+     suite.add("bot/depth3/threads4", bot_case(3, size_t(4) << 20, 4));
+     //ÿÿ̵Ĺƽһһ֡1024 ʱֵ˳
+     suite.add("game/tick_encode", [&](bench_state &st) {
+         static const int NG = 1024;
+         static TetrisGame games[NG];
+         static uint8_t frame[TetrisGame::MAX_FRAME];
+         static const int keys[] = {GAME_KEY_LEFT, GAME_KEY_RIGHT, GAME_KEY_ROTATE, GAME_KEY_DOWN};
+         pcg32 r(suite.seed());
+         for(int g = 0; g < NG; g++) {
+             games[g].start(&pieces[0], nPiece, PIECE_BAG, suite.seed() + g);
+             games[g].encode_delta(frame);
+         }
+         uint64_t bytes = 0, now = 0;
+         for(uint64_t i = 0; i < st.iterations(); i++) {
+             TetrisGame &g = games[i & (NG-1)];
+             if ((i & (NG-1)) == 0)
+                 now += 100;
+             g.key(keys[r.below(4)]);
+             g.tick(now);
+             bytes += g.encode_delta(frame);
+         }
+         st.set_items(st.iterations());
+         st.set_bytes(bytes);
+     });
+     //̽ģټʱ
+     if (CheckMoveGen(rng, pieces, 2048))
+         cerr << "movegen̽һ!\n";
+     //ɣ64   ַ飬ÿεһַȫ㡣
+     //  collide_probe ԭÿÿһдӶ Block::collide ̽
+     //  hard_drop Ԥÿ͸һbfs ƽơתɴλ
+     static int boardsMove[NB][GameH][GameW];
+     vector <bot_board> botBoards(NB);
+     for(int b = 0; b < NB; b++) {
+         RandomBoard(rng, boardsMove[b], 0);
+         for(int i = 0; i < GameH/2 + 2; i++) {
+             memset(boardsMove[b][i], 0, sizeof(boardsMove[b][i]));
+         }
+         botBoards[b].load(boardsMove[b]);
+     }
+     suite.add("movegen/collide_probe", [&](bench_state &st) {
+         uint64_t found = 0;
+         for(uint64_t i = 0; i < st.iterations(); i++) {
+             int k = (int)(i % nPiece);
+             memcpy(g_nGameBack, boardsMove[(i / nPiece) & (NB-1)], sizeof(g_nGameBack));
+             Block &blk = blocks[k];
+             for(int ro = 0; ro < 4; ro++) {
+                 for(int x = -3; x < GameW; x++) {
+                     blk.x = x;
+                     blk.y = 0;
+                     if (blk.collide(0, 0, ro))
+                         continue;
+                     while (!blk.collide(0, 1, ro))
+                         blk.y++;
+                     found++;
+                 }
+             }
+         }
+         st.set_items(st.iterations());
+         st.counter("moves", (double)found / st.iterations());
+     });
+     suite.add("movegen/hard_drop", [&](bench_state &st) {
+         uint64_t found = 0;
+         for(uint64_t i = 0; i < st.iterations(); i++) {
+             const bot_board &b = botBoards[(i / nPiece) & (NB-1)];
+             bot_for_each_drop(b, pieces[i % nPiece], [&](int, int, int) { found++; });
+         }
+         st.set_items(st.iterations());
+         st.counter("moves", (double)found / st.iterations());
+     });
+     suite.add("movegen/bfs", [&](bench_state &st) {
+         static bot_reach reach;
+         uint64_t found = 0;
+         for(uint64_t i = 0; i < st.iterations(); i++) {
+             const bot_board &b = botBoards[(i / nPiece) & (NB-1)];
+             found += reach.run(b, pieces[i % nPiece], 0, 4, 0);
+         }
+         st.set_items(st.iterations());
+         st.counter("moves", (double)found / st.iterations());
+     });
+     return suite.run();
+}
@@ -1,41 +1,88 @@
 #include<iostream>
-#include<windows.h>
+#include<string>
+#include<vector>
+#include<chrono>
+#include<thread>
+#include"timer_wheel.h"
+#include"gbk_utf8.h"
+#include"terminal.h"
 using namespace std;
 
-//ع
-void HideCursor()
+typedef chrono::steady_clock Clock;        //ʱӣϵͳʱӰ
+
+//˯ʱtȽϵͳ˯tǰ1msʣµ㣬Ǻ뼶
+void SleepUntil(Clock::time_point t)
 {
- CONSOLE_CURSOR_INFO cursor_info = {1, 0}; 
- SetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &cursor_info);
+ const Clock::duration spin=chrono::milliseconds(1);
+ if(Clock::now()+spin<t)
+  this_thread::sleep_until(t-spin);
+ while(Clock::now()<t)
+  this_thread::yield();
 }
-//ʾ
-void DispCursor()
+
+//ѵrowУ1ʼػΪһʱĵǰ״̬׷ӵoutȴһ
+void DrawLine(string &out,int row,const string &name,int sec)
 {
- CONSOLE_CURSOR_INFO cursor_info = {1, 1}; 
- SetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &cursor_info);
-} 
+ out+="\033["+to_string(row)+";1H"+name+"";
+ if(sec>0)
+  out+="ʱʣ"+to_string(sec)+"s";
+ else
+  out+="Time Over";
+ out+="\033[K";
+}
 
 int main(void)
 {
-	int sec;
-	cout<<"뿪ʼʱ():";
-	cin>>sec;
-	cout<<"سʼʱ";
-	while(getchar()!='\n')
+	ConsoleText console;     //ն˱Դ벻ͬʱԶת
+	int n,i;
+	cout<<"뵹ʱ:";
+	cin>>n;
+	vector<string> name(n);
+	vector<int> sec(n);
+	for(i=0;i<n;i++)
 	{
+		cout<<""<<i+1<<"ʱ뿪ʼʱ():";
+		cin>>name[i]>>sec[i];
 	}
-	
-	system("cls");
-	//ʼʱ
-	 HideCursor();
-	 while(sec!=0)
+	cout<<"سʼʱ";
+	cin.ignore(1024,'\n');
+	cin.get();
+
+	term_init(false);        //ֻҪص׼Windows  VT С1ms ʱȣ԰ж
+	term_clear();
+	//ʼʱеʱͬһʱϣ1̶=1ms
+	//ÿ̶ȶͬһ㣬ʱۻƯ
+	 term_cursor(false);
+	 Clock::time_point start=Clock::now();
+	 TimerWheel wheel;
+	 string frame;
+	 for(i=0;i<n;i++)
+	 {
+	 	DrawLine(frame,i+1,name[i],sec[i]);
+	 	if(sec[i]>0)
+	 		wheel.add(name[i],1000,i);
+	 }
+	 cout<<frame<<flush;
+	 while(wheel.size())
 	 {
-	 	cout<<"ʱʣ"<<sec<<"s";
-	 	sec=sec-1;
-	 	Sleep(1000);
-	 	system("cls");
+	 	uint64_t t=wheel.next_tick();
+	 	SleepUntil(start+chrono::milliseconds(t));
+	 	wheel.advance(t,[&](const vector<TimerWheel::event> &ev)
+	 	{
+	 		//ͬһ̶ȵڵĵʱһػֻһ
+	 		frame.clear();
+	 		for(size_t k=0;k<ev.size();k++)
+	 		{
+	 			int row=(int)wheel.user(ev[k].h);
+	 			sec[row]--;
+	 			DrawLine(frame,row+1,wheel.name(ev[k].h),sec[row]);
+	 			if(sec[row]>0)
+	 				wheel.reschedule(ev[k].h,ev[k].due+1000);
+	 		}
+	 		cout<<frame<<flush;
+	 	});
 	 }
-	 cout<<"Time Over";
-	 DispCursor();
+	 cout<<"\033["<<n+1<<";1H"<<endl;
+	 term_restore();
 	 return 0;
 }
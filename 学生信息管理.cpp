@@ -1,7 +1,10 @@
 #include<iostream>
 #include<string>
+#include"out_sink.h"
 using namespace std;
 
+static OutSink out;          //ܵʱһд
+
 class student
 {
 	private:
@@ -21,15 +24,15 @@ class student
 		}
 		void disp()
 		{
-			cout<<"->"<<"Name:"<<Name<<'/'<<"ID:"<<ID;
-			cout<<endl;
-			cout<<"Grade:"<<Grade<<endl;
-			cout<<endl;
+			out<<"->"<<"Name:"<<Name<<'/'<<"ID:"<<ID;
+			out<<'\n';
+			out<<"Grade:"<<Grade<<'\n';
+			out<<'\n';
 		}
 		void output()
 		{
-			cout<<"Number of students is:"<<N<<endl;
-			cout<<"Average score is:"<<Gradesum/3;
+			out<<"Number of students is:"<<N<<'\n';
+			out<<"Average score is:"<<Gradesum/3;
 		}
 };
 
@@ -1,93 +1,385 @@
 #include<iostream>
-#include<string.h>
+#include<fstream>
+#include<sstream>
+#include<string>
+#include<vector>
+#include<cstring>
+#include"bench.h"
+#include"gbk_utf8.h"
+#include"out_sink.h"
+#include"trace.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include<emmintrin.h>
+#define GRADE_SSE2 1
+#endif
 using namespace std;
-class student
+
+const int PASSLINE=60;              //
+const int FLUSHROWS=65536;          //ͳÿۼôоͰ32λͲ64λܺ
+
+//γ̱γĿʱ룬д
+class course_schema
+{
+	protected:
+		vector<string> names;
+	public:
+		void add(const string &Name)
+		{
+			names.push_back(Name);
+		}
+		//ļγÿһţк
+		bool load(const char *path)
+		{
+			ifstream fin(path);
+			if(!fin)
+				return false;
+			string line;
+			while(getline(fin,line))
+			{
+				if(!line.empty()&&line[line.size()-1]=='\r')
+					line.erase(line.size()-1);
+				if(!line.empty())
+					names.push_back(line);
+			}
+			return !names.empty();
+		}
+		int size() const
+		{
+			return (int)names.size();
+		}
+		const string &name(int k) const
+		{
+			return names[k];
+		}
+};
+
+//ſγ̵ͳƽ
+struct course_stat
+{
+	long long sum;
+	int fail;
+	int low;
+	int high;
+	double average;
+};
+
+//ɼÿѧһУţп뵽4ı벿ֺΪ0
+class grade_table
 {
 	protected:
-		string name;
-		int id;
-		
-		int Cgrade;            // 
-		int Xgrade;            //źŴ 
-		int Sgrade;            //ݽṹ 
-		
-		double average;       //ÿѧƽ 
-		double sumaver;      //ÿſγƽ 
+		const course_schema *schema;
+		int stride;
+		vector<string> name;
+		vector<int> id;
+		vector<int> grade;
+		vector<double> average;     //ÿѧƽ
 	public:
-		//¼ѧϢ 
-	    void init(string Name,int ID,int x,int y,int z)
-		{
-			name=Name;
-			id=ID;
-			Cgrade=x;
-			Xgrade=y;
-			Sgrade=z;
-		}
-		//ÿѧƽ 
-		double aver(int x,int y,int z)
-		{
-			return average=((x+y+z)/3);
-		}
-		//ѧϢ 
-		void print()
-		{
-			cout<<"->";
-			cout<<""<<name<<' ';
-			cout<<"ѧţ"<<id<<' ';
-			cout<<endl;
-			cout<<"ƣ"<<Cgrade<<' ';
-			cout<<"źŴ"<<Xgrade<<' ';
-			cout<<"ݽṹ"<<Sgrade<<' '<<endl;
-			cout<<"ƽɼ"<<average<<endl;
-			cout<<endl;
-		}
-		// 
-		void failprint(int count1,int count2,int count3)
-		{
-			cout<<"----------------------"<<endl;
-		    cout<<"Ʋ"<<count1<<endl;
-			cout<<"źŴ"<<count2<<endl;
-			cout<<"ݽṹ"<<count3<<endl;
-		}
-} ;
+		grade_table(const course_schema &s)
+		{
+			schema=&s;
+			stride=(s.size()+3)&~3;
+		}
+		int rows() const
+		{
+			return (int)id.size();
+		}
+		int columns() const
+		{
+			return schema->size();
+		}
+		void reserve(int n)
+		{
+			if(n<0)
+				n=0;
+			name.reserve(n);
+			id.reserve(n);
+			grade.reserve((size_t)n*stride);
+			average.reserve(n);
+		}
+		//׷һѧɼйдûпγʱпΪ0nullptr
+		int *append(const string &Name,int ID)
+		{
+			name.push_back(Name);
+			id.push_back(ID);
+			average.push_back(0);
+			if(stride==0)
+				return nullptr;
+			grade.resize(grade.size()+stride,0);
+			return &grade[grade.size()-stride];
+		}
+		const int *row(int i) const
+		{
+			return grade.data()+(size_t)i*stride;
+		}
+		//һгɼͣ벿Ϊ0Ӱ
+		long long row_sum(int i) const
+		{
+			const int *r=row(i);
+			long long s=0;
+			int k=0;
+#if defined(GRADE_SSE2)
+			__m128i acc=_mm_setzero_si128();
+			for(;k<stride;k+=4)
+				acc=_mm_add_epi32(acc,_mm_loadu_si128((const __m128i*)(r+k)));
+			int lane[4];
+			_mm_storeu_si128((__m128i*)lane,acc);
+			s=(long long)lane[0]+lane[1]+lane[2]+lane[3];
+#endif
+			for(;k<stride;k++)
+				s+=r[k];
+			return s;
+		}
+		//ÿѧƽ֣ٽضϣ
+		void aver()
+		{
+			TRACE_SCOPE("grades/aver");
+			int n=rows(),m=columns();
+			for(int i=0;i<n;i++)
+				average[i]=m?(double)row_sum(i)/m:0;
+		}
+		//ͳܷ֡ͷ߷
+		vector<course_stat> stats() const
+		{
+			TRACE_SCOPE("grades/stats");
+			int n=rows(),m=columns();
+			vector<long long> total(stride,0);
+			vector<int> sum(stride,0),fail(stride,0),low(stride,0),high(stride,0);
+			if(n>0)
+			{
+				const int *r=row(0);
+				for(int k=0;k<stride;k++)
+					low[k]=high[k]=r[k];
+			}
+			for(int i=0;i<n;i++)
+			{
+				const int *r=row(i);
+				int k=0;
+#if defined(GRADE_SSE2)
+				const __m128i pass=_mm_set1_epi32(PASSLINE);
+				for(;k<stride;k+=4)
+				{
+					__m128i g=_mm_loadu_si128((const __m128i*)(r+k));
+					__m128i s=_mm_loadu_si128((const __m128i*)&sum[k]);
+					__m128i f=_mm_loadu_si128((const __m128i*)&fail[k]);
+					__m128i lo=_mm_loadu_si128((const __m128i*)&low[k]);
+					__m128i hi=_mm_loadu_si128((const __m128i*)&high[k]);
+					__m128i lt=_mm_cmplt_epi32(g,lo);
+					__m128i gt=_mm_cmpgt_epi32(g,hi);
+					s=_mm_add_epi32(s,g);
+					f=_mm_sub_epi32(f,_mm_cmplt_epi32(g,pass));     //ȽϽΪ-1ȥ
+					lo=_mm_or_si128(_mm_and_si128(lt,g),_mm_andnot_si128(lt,lo));
+					hi=_mm_or_si128(_mm_and_si128(gt,g),_mm_andnot_si128(gt,hi));
+					_mm_storeu_si128((__m128i*)&sum[k],s);
+					_mm_storeu_si128((__m128i*)&fail[k],f);
+					_mm_storeu_si128((__m128i*)&low[k],lo);
+					_mm_storeu_si128((__m128i*)&high[k],hi);
+				}
+#endif
+				for(;k<stride;k++)
+				{
+					int g=r[k];
+					sum[k]+=g;
+					fail[k]+=g<PASSLINE;
+					low[k]=g<low[k]?g:low[k];
+					high[k]=g>high[k]?g:high[k];
+				}
+				if((i+1)%FLUSHROWS==0)
+				{
+					for(k=0;k<stride;k++)
+					{
+						total[k]+=sum[k];
+						sum[k]=0;
+					}
+				}
+			}
+			vector<course_stat> out(m);
+			for(int k=0;k<m;k++)
+			{
+				out[k].sum=total[k]+sum[k];
+				out[k].fail=fail[k];
+				out[k].low=low[k];
+				out[k].high=high[k];
+				out[k].average=n?(double)out[k].sum/n:0;
+			}
+			return out;
+		}
+		//ѧϢ
+		void print(OutSink &out,int i) const
+		{
+			const int *r=row(i);
+			out<<"->";
+			out<<""<<name[i]<<' ';
+			out<<"ѧţ"<<id[i]<<' ';
+			out<<'\n';
+			for(int k=0;k<columns();k++)
+				out<<schema->name(k)<<""<<r[k]<<' ';
+			out<<'\n';
+			out<<"ƽɼ"<<average[i]<<'\n';
+			out<<'\n';
+		}
+		//ÿſγƽ
+		void failprint(OutSink &out,const vector<course_stat> &st) const
+		{
+			int k;
+			out<<"----------------------\n";
+			for(k=0;k<columns();k++)
+				out<<schema->name(k)<<""<<st[k].fail<<'\n';
+			out<<"----------------------\n";
+			for(k=0;k<columns();k++)
+				out<<schema->name(k)<<"ƽΪ:"<<st[k].average
+				   <<""<<st[k].low<<""<<st[k].high<<"\n";
+		}
+};
 
-int main()
+int bench(int argc,char *argv[]);
+
+//÷ѧɼ [γ̱ļ]δļʱγ
+//      ѧɼ --bench [ѧ] [--format=json ...] bench.h
+int main(int argc,char *argv[])
 {
-	int n,i,j;
-	double Csum=0,Xsum=0,Ssum=0;
-	int count1=0,count2=0,count3=0;
+	if(argc>1&&strcmp(argv[1],"--bench")==0)
+		return bench(argc,argv);
+	ConsoleText console;     //ն˱Դ벻ͬʱԶת
+	int m,n,i,k;
 	string Name;
-	int ID,x,y,z;
+	int ID;
+	course_schema schema;
+	if(argc>1)
+	{
+		if(!schema.load(argv[1]))
+		{
+			cout<<"޷ȡγ̱"<<argv[1]<<endl;
+			return 1;
+		}
+	}
+	else
+	{
+		cout<<"γ";
+		cin>>m;
+		for(k=0;k<m;k++)
+		{
+			cout<<"γ"<<k+1<<"ƣ";
+			cin>>Name;
+			schema.add(Name);
+		}
+		cout<<endl;
+	}
+	grade_table table(schema);
 	cout<<"ѧ";
 	cin>>n;
 	cout<<endl;
-	student stu[n];
+	table.reserve(n);
 	for(i=0;i<n;i++)
 	{
+		TRACE_SCOPE("grades/student");       //ȴʱ䣻ļضʱΪʱ
 		cout<<"ѧ"<<i+1<<"";
 		cin>>Name;
 		cout<<"ѧ"<<i+1<<"ѧţ";
 		cin>>ID;
 		cout<<"ѧ"<<i+1<<"ɼ";
-		cin>>x>>y>>z;
-		Csum=Csum+x;        //ܷ 
-		Xsum=Xsum+y;        //źŴܷ 
-		Ssum=Ssum+z;        //ݽṹܷ 
-		if(x<60) count1++;                  //ͳƳƲ 
-		if(y<60) count2++;                  //ͳźŴ 
-		if(z<60) count3++;                  //ͳݽṹ 
-		stu[i].init(Name,ID,x,y,z);        //¼ѧϢ 
-		stu[i].aver(x,y,z);               //ѧƽ 
+		int *r=table.append(Name,ID);        //¼ѧϢ
+		for(k=0;k<schema.size();k++)
+			cin>>r[k];
 		cout<<endl;
+		TRACE_COUNT("grades/rows",1);
 	}
-	cout<<"----------------------"<<endl;
-	for(j=0;j<n;j++)
+	table.aver();                            //ѧƽ
+	cout<<flush;
+	//ڻʱһд
+	OutSink out;
+	TRACE_SCOPE("grades/report");
+	out<<"----------------------\n";
+	for(i=0;i<table.rows();i++)
 	{
-		stu[j].print();
+		table.print(out,i);
 	}
-	stu[0].failprint(count1,count2,count3);
-	cout<<"----------------------"<<endl;
-	cout<<"ƽΪ:"<<Csum/n<<endl;
-	cout<<"źŴƽΪ:"<<Xsum/n<<endl;
-	cout<<"ݽṹƽΪ:"<<Ssum/n<<endl;
+	table.failprint(out,table.stats());
+	out.flush();
+	return 0;
+}
+
+//һѧѧšƳɼ뽻¼˳ͬ
+static bool read_student(istream &in,grade_table &table,int courses)
+{
+	string Name;
+	int ID;
+	if(!(in>>Name>>ID))
+		return false;
+	int *r=table.append(Name,ID);
+	for(int k=0;k<courses;k++)
+		in>>r[k];
+	return (bool)in;
+}
+
+//ɼ̶ɣ0~1006ſγ̣¼ͬʽıʾ
+int bench(int argc,char *argv[])
+{
+	BenchSuite suite("student_grades",argc,argv,2);
+	int n=suite.positional().empty()?100000:atoi(suite.positional()[0].c_str());
+	course_schema schema;
+	const char *names[]={"Chinese","Math","English","Physics","Chemistry","Biology"};
+	for(int k=0;k<6;k++)
+		schema.add(names[k]);
+	bench_rng rng(suite.seed());
+	string text;
+	for(int i=0;i<n;i++)
+	{
+		text+="s"+to_string(i)+' '+to_string(20240000+i);
+		for(int k=0;k<schema.size();k++)
+			text+=' '+to_string(rng.range(0,100));
+		text+='\n';
+	}
+	grade_table table(schema);
+	table.reserve(n);
+	istringstream in(text);
+	while(read_student(in,table,schema.size()))
+		;
+
+	suite.add("input/"+to_string(n),[&](bench_state &st)
+	{
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			grade_table t(schema);
+			t.reserve(n);
+			istringstream is(text);
+			while(read_student(is,t,schema.size()))
+				;
+			bench_keep(t.rows());
+		}
+		st.set_items(st.iterations()*n);
+		st.set_bytes(st.iterations()*text.size());
+	});
+	suite.add("aver/"+to_string(n),[&](bench_state &st)
+	{
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			table.aver();
+			bench_clobber();
+		}
+		st.set_items(st.iterations()*n);
+	});
+	suite.add("stats/"+to_string(n),[&](bench_state &st)
+	{
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			vector<course_stat> cs=table.stats();
+			bench_keep(cs[0].sum);
+		}
+		st.set_items(st.iterations()*n);
+	});
+	//ʽݱд豸
+	suite.add("report/"+to_string(n),[&](bench_state &st)
+	{
+		OutSink out(bench_null_file());
+		vector<course_stat> cs=table.stats();
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			for(int r=0;r<table.rows();r++)
+				table.print(out,r);
+			table.failprint(out,cs);
+			out.flush();
+		}
+		st.set_items(st.iterations()*n);
+	});
+	return suite.run();
 }
@@ -1,21 +1,148 @@
 #include<iostream>
+#include<iomanip>
+#include<vector>
+#include<algorithm>
+#include<cstdlib>
+#include<cstring>
+#include"bench.h"
+#include"pair_order.h"
+#include"sort_engine.h"
 using namespace std;
 void change(int &a,int &b);
-int main()
+int bench(int argc,char *argv[]);
+int batch();
+int main(int argc,char *argv[])
 {
+	//ñȴС --bench [N] [--format=json ...] change() ɶ
+	// N ѧ/ɼ¼Աȸʵ֣ bench.h
+	if(argc>1&&strcmp(argv[1],"--bench")==0)
+		return bench(argc,argv);
+	//ñȴС --batchÿ԰Сһ
+	if(argc>1&&strcmp(argv[1],"--batch")==0)
+		return batch();
 	int x,y;
 	cin>>x>>y;
 	change(x,y);
 	cout<<x<<' '<<y;
 	return 0;
 }
+//һźж
+int batch()
+{
+	vector<int32_t> xy;
+	int x,y;
+	while(cin>>x>>y)
+	{
+		xy.push_back(x);
+		xy.push_back(y);
+	}
+	order_pairs_interleaved(xy.data(),xy.size()/2);
+	for(size_t i=0;i<xy.size();i+=2)
+	{
+		if(i)
+			cout<<'\n';
+		cout<<xy[i]<<' '<<xy[i+1];
+	}
+	return 0;
+}
+//޷֧ȡ min/max²֧Ԥʧܶͣ
 void change(int &a,int &b)
 {
-	int temp;
-	if(a>b)
+	cswap(a,b);
+}
+
+struct record
+{
+	uint32_t id;
+	int32_t grade;
+};
+//ɼٰѧ
+static bool by_grade(const record &a,const record &b)
+{
+	return a.grade<b.grade||(a.grade==b.grade&&a.id<b.id);
+}
+static uint64_t grade_key(const record &r)
+{
+	return (uint64_t)(uint32_t)r.grade<<32|r.id;
+}
+
+//ÿʵһ std::sort Ľ˶ԣһʱʱÿεͬһݵĿʼ
+template<class T,class F>
+static void add_sort(BenchSuite &suite,const string &name,const vector<T> &src,const vector<T> &ref,F sort_fn)
+{
+	vector<T> v(src);
+	sort_fn(v);
+	if(memcmp(v.data(),ref.data(),v.size()*sizeof(T))!=0)
+		cerr<<name<<" std::sort һ!\n";
+	suite.add(name,[&src,sort_fn](bench_state &st)
 	{
-		temp=a;
-		a=b;
-		b=temp;
+		vector<T> w(src.size());
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			memcpy(w.data(),src.data(),src.size()*sizeof(T));
+			sort_fn(w);
+			bench_clobber();
+		}
+		st.set_items(st.iterations()*src.size());
+	});
+}
+
+int bench(int argc,char *argv[])
+{
+	BenchSuite suite("order_pair",argc,argv,2);
+	size_t n=suite.positional().empty()?1000000:strtoul(suite.positional()[0].c_str(),0,10);
+	bench_rng rng(suite.seed());
+	//ɶԱȽϣ4096ԼһҪ
+	vector<int32_t> xy(8192);
+	for(size_t i=0;i<xy.size();i++)
+		xy[i]=(int32_t)rng.next();
+	vector<record> rec(n);
+	vector<int32_t> key(n);
+	for(size_t i=0;i<n;i++)
+	{
+		uint64_t s=rng.next();
+		rec[i].id=(uint32_t)(s>>32);
+		rec[i].grade=(int32_t)(s%101);
+		key[i]=(int32_t)s;
 	}
+	vector<record> rref(rec);
+	sort(rref.begin(),rref.end(),by_grade);
+	vector<int32_t> kref(key);
+	sort(kref.begin(),kref.end());
+
+	suite.add("change",[&](bench_state &st)
+	{
+		vector<int32_t> w(xy);
+		size_t pairs=w.size()/2;
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			size_t k=(i%pairs)*2;
+			change(w[k],w[k+1]);
+			bench_clobber();
+		}
+		st.set_items(st.iterations());
+	});
+	suite.add("order_pairs_interleaved/4096",[&](bench_state &st)
+	{
+		vector<int32_t> w(xy.size());
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			memcpy(w.data(),xy.data(),xy.size()*sizeof(int32_t));
+			order_pairs_interleaved(w.data(),w.size()/2);
+			bench_clobber();
+		}
+		st.set_items(st.iterations()*(xy.size()/2));
+	});
+	string ns=to_string(n);
+	//ѧ/ɼ¼ɼѧţ
+	add_sort(suite,"records/std::sort/"+ns,rec,rref,[](vector<record> &v){sort(v.begin(),v.end(),by_grade);});
+	add_sort(suite,"records/merge_sort/"+ns,rec,rref,[](vector<record> &v){merge_sort(v.data(),v.size(),by_grade);});
+	add_sort(suite,"records/parallel_sort/"+ns,rec,rref,[](vector<record> &v){parallel_sort(v.data(),v.size(),0,by_grade);});
+	add_sort(suite,"records/radix_sort_by/"+ns,rec,rref,[](vector<record> &v){radix_sort_by(v.data(),v.size(),grade_key);});
+	//int32 
+	add_sort(suite,"int32/std::sort/"+ns,key,kref,[](vector<int32_t> &v){sort(v.begin(),v.end());});
+	add_sort(suite,"int32/merge_sort/"+ns,key,kref,[](vector<int32_t> &v){merge_sort(v.data(),v.size());});
+	add_sort(suite,"int32/parallel_sort/"+ns,key,kref,[](vector<int32_t> &v){parallel_sort(v.data(),v.size());});
+	add_sort(suite,"int32/radix_sort/"+ns,key,kref,[](vector<int32_t> &v){radix_sort(v.data(),v.size());});
+	return suite.run();
 }
@@ -1,14 +1,27 @@
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
+#include "bench.h"
+#include "isa_dispatch.h"
+#include "out_sink.h"
+#include "trace.h"
+#if defined(ISA_X86_VARIANTS)
+#include <immintrin.h>
+#endif
+#if defined(ISA_NEON_VARIANTS)
+#include <arm_neon.h>
+#endif
 
-float f(float x, float y, float z) 
+#define ROWMAX 128          //ÿַͼÿ 120 
+
+float f(float x, float y, float z)
 {
     float a;
 	a = x * x + 9.0f / 4.0f * y * y + z * z - 1;
     return a * a * a - x * x * z * z * z - 9.0f / 80.0f * y * y * z * z * z;
 }
 
-float h(float x, float z) 
+float h(float x, float z)
 {
 	float y;
     for ( y = 1.0f; y >= 0.0f; y -= 0.001f)
@@ -17,27 +30,255 @@ float h(float x, float z)
     return 0.0f;
 }
 
-int main(void) 
+//һ x ͬʱ h(x[i], z)need[i] Ϊ 0 λò 0
+typedef void (*h_row_fn)(const float *x, float z, const unsigned char *need, float *out, int n);
+
+//߰汾 h
+static void h_row_base(const float *x, float z, const unsigned char *need, float *out, int n)
+{
+	int i;
+	for (i = 0; i < n; i++)
+		out[i] = need[i] ? h(x[i], z) : 0.0f;
+}
+
+//汾˼·ͬһ z ͬ y ɨж x Ҳͬ
+//ÿ y ֻһκ y ٶһ x  fͨҵǰ
+//˳ f һ£λͬ
+#if defined(ISA_X86_VARIANTS)
+ISA_TARGET_AVX2
+static void h_row_avx2(const float *x, float z, const unsigned char *need, float *out, int n)
+{
+	const float zz = z * z;
+	const __m256 vz = _mm256_set1_ps(z), one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps();
+	int i, k;
+	for (i = 0; i < n; i += 8)
+	{
+		float xb[8], r[8];
+		unsigned m = 0;
+		for (k = 0; k < 8; k++)
+		{
+			xb[k] = i + k < n ? x[i + k] : 0.0f;
+			r[k] = 0.0f;
+			if (i + k < n && need[i + k])
+				m |= 1u << k;
+		}
+		__m256 vx = _mm256_loadu_ps(xb);
+		__m256 xx = _mm256_mul_ps(vx, vx);
+		__m256 b = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(xx, vz), vz), vz);
+		float y;
+		for (y = 1.0f; m && y >= 0.0f; y -= 0.001f)
+		{
+			__m256 t1 = _mm256_set1_ps(9.0f / 4.0f * y * y);
+			__m256 t3 = _mm256_set1_ps(9.0f / 80.0f * y * y * z * z * z);
+			__m256 a = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(xx, t1), _mm256_set1_ps(zz)), one);
+			__m256 v = _mm256_sub_ps(_mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(a, a), a), b), t3);
+			unsigned hit = (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(v, zero, _CMP_LE_OQ)) & m;
+			for (k = 0; hit >> k; k++)
+				if (hit >> k & 1)
+					r[k] = y;
+			m &= ~hit;
+		}
+		for (k = 0; k < 8 && i + k < n; k++)
+			out[i + k] = r[k];
+	}
+}
+
+ISA_TARGET_AVX512
+static void h_row_avx512(const float *x, float z, const unsigned char *need, float *out, int n)
+{
+	const float zz = z * z;
+	const __m512 vz = _mm512_set1_ps(z), one = _mm512_set1_ps(1.0f), zero = _mm512_setzero_ps();
+	int i, k;
+	for (i = 0; i < n; i += 16)
+	{
+		float xb[16], r[16];
+		unsigned m = 0;
+		for (k = 0; k < 16; k++)
+		{
+			xb[k] = i + k < n ? x[i + k] : 0.0f;
+			r[k] = 0.0f;
+			if (i + k < n && need[i + k])
+				m |= 1u << k;
+		}
+		__m512 vx = _mm512_loadu_ps(xb);
+		__m512 xx = _mm512_mul_ps(vx, vx);
+		__m512 b = _mm512_mul_ps(_mm512_mul_ps(_mm512_mul_ps(xx, vz), vz), vz);
+		float y;
+		for (y = 1.0f; m && y >= 0.0f; y -= 0.001f)
+		{
+			__m512 t1 = _mm512_set1_ps(9.0f / 4.0f * y * y);
+			__m512 t3 = _mm512_set1_ps(9.0f / 80.0f * y * y * z * z * z);
+			__m512 a = _mm512_sub_ps(_mm512_add_ps(_mm512_add_ps(xx, t1), _mm512_set1_ps(zz)), one);
+			__m512 v = _mm512_sub_ps(_mm512_sub_ps(_mm512_mul_ps(_mm512_mul_ps(a, a), a), b), t3);
+			unsigned hit = (unsigned)_mm512_cmp_ps_mask(v, zero, _CMP_LE_OQ) & m;
+			for (k = 0; hit >> k; k++)
+				if (hit >> k & 1)
+					r[k] = y;
+			m &= ~hit;
+		}
+		for (k = 0; k < 16 && i + k < n; k++)
+			out[i + k] = r[k];
+	}
+}
+#endif
+
+#if defined(ISA_NEON_VARIANTS)
+static void h_row_neon(const float *x, float z, const unsigned char *need, float *out, int n)
+{
+	const float zz = z * z;
+	const float32x4_t vz = vdupq_n_f32(z), one = vdupq_n_f32(1.0f), zero = vdupq_n_f32(0.0f);
+	int i, k;
+	for (i = 0; i < n; i += 4)
+	{
+		float xb[4], r[4];
+		uint32_t lane[4];
+		unsigned m = 0;
+		for (k = 0; k < 4; k++)
+		{
+			xb[k] = i + k < n ? x[i + k] : 0.0f;
+			r[k] = 0.0f;
+			if (i + k < n && need[i + k])
+				m |= 1u << k;
+		}
+		float32x4_t vx = vld1q_f32(xb);
+		float32x4_t xx = vmulq_f32(vx, vx);
+		float32x4_t b = vmulq_f32(vmulq_f32(vmulq_f32(xx, vz), vz), vz);
+		float y;
+		for (y = 1.0f; m && y >= 0.0f; y -= 0.001f)
+		{
+			float32x4_t t1 = vdupq_n_f32(9.0f / 4.0f * y * y);
+			float32x4_t t3 = vdupq_n_f32(9.0f / 80.0f * y * y * z * z * z);
+			float32x4_t a = vsubq_f32(vaddq_f32(vaddq_f32(xx, t1), vdupq_n_f32(zz)), one);
+			float32x4_t v = vsubq_f32(vsubq_f32(vmulq_f32(vmulq_f32(a, a), a), b), t3);
+			vst1q_u32(lane, vcleq_f32(v, zero));
+			unsigned hit = ((lane[0] & 1) | (lane[1] & 2) | (lane[2] & 4) | (lane[3] & 8)) & m;
+			for (k = 0; k < 4; k++)
+				if (hit >> k & 1)
+					r[k] = y;
+			m &= ~hit;
+		}
+		for (k = 0; k < 4 && i + k < n; k++)
+			out[i + k] = r[k];
+	}
+}
+#endif
+
+//ʱִе汾ֻ֮ɺָ
+static h_row_fn pick_h_row(void)
 {
-	float z,x,v,y0,ny,nx,nz,nd,d;
-	    for ( z = 1.5f; z > -1.5f; z -= 0.05f) 
+	h_row_fn neon = 0, avx2 = 0, avx512 = 0;
+#if defined(ISA_NEON_VARIANTS)
+	neon = h_row_neon;
+#endif
+#if defined(ISA_X86_VARIANTS)
+	avx2 = h_row_avx2;
+	avx512 = h_row_avx512;
+#endif
+	return isa_select(isa_detect(), h_row_base, neon, avx2, avx512);
+}
+
+static const h_row_fn h_row = pick_h_row();
+
+int bench(int argc, char *argv[]);
+
+int main(int argc, char *argv[])
+{
+	// --bench [--format=json ...] fh ֵ bench.h
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+		return bench(argc, argv);
+	float z,x,y0,ny,nx,nz,nd,d;
+	float xs[ROWMAX], xs1[ROWMAX], h0[ROWMAX], h1[ROWMAX], h2[ROWMAX];
+	unsigned char need[ROWMAX];
+	int i,n;
+	OutSink out;                //ͼһд
+	    for ( z = 1.5f; z > -1.5f; z -= 0.05f)
 		{
-	        for ( x = -1.5f; x < 1.5f; x += 0.025f) 
+			TRACE_SCOPE("heart/row");
+			n = 0;
+	        for ( x = -1.5f; x < 1.5f && n < ROWMAX; x += 0.025f)
 			{
-	             v = f(x, 0.0f, z);
-	            if (v <= 0.0f) 
+	             xs[n] = x;
+	             xs1[n] = x + 0.01f;
+	             need[n] = f(x, 0.0f, z) <= 0.0f;
+	             n++;
+	        }
+	        ny = 0.01f;
+	        {
+	            TRACE_SCOPE("heart/h");     // h۷ɵĸ汾
+	            h_row(xs, z, need, h0, n);
+	            h_row(xs1, z, need, h1, n);
+	            h_row(xs, z + ny, need, h2, n);
+	        }
+	        for ( i = 0; i < n; i++)
+			{
+	            if (need[i])
 				{
-	                 y0 = h(x, z);
-	                 ny = 0.01f;
-	                 nx = h(x + ny, z) - y0;
-	                 nz = h(x, z + ny) - y0;
+	                 y0 = h0[i];
+	                 nx = h1[i] - y0;
+	                 nz = h2[i] - y0;
 	                 nd = 1.0f / sqrtf(nx * nx + ny * ny + nz * nz);
 	                 d = (nx + ny - nz) * nd * 0.5f + 0.5f;
-	                putchar(".:-=+*#%@"[(int)(d * 5.0f)]);
+	                out.put(".:-=+*#%@"[(int)(d * 5.0f)]);
 	            }
 	            else
-	                putchar(' ');
+	                out.put(' ');
 	        }
-	        putchar('\n');
+	        out.put('\n');
 	    }
+	out.flush();
+}
+
+//ȡͼʵʳֵĵ㣺xz ڻͼΧھӹ̶
+int bench(int argc, char *argv[])
+{
+	BenchSuite suite("heart", argc, argv, 2);
+	bench_rng rng(suite.seed());
+	std::vector<float> px(4096), py(4096), pz(4096);
+	for (size_t i = 0; i < px.size(); i++)
+	{
+		px[i] = (float)rng.uniform(-1.5, 1.5);
+		py[i] = (float)rng.uniform(0.0, 1.0);
+		pz[i] = (float)rng.uniform(-1.5, 1.5);
+	}
+	//һе x  need main еĹ췽ʽͬ
+	float xs[ROWMAX], out[ROWMAX];
+	unsigned char need[ROWMAX];
+	const float z = 0.5f;
+	int n = 0;
+	for (float x = -1.5f; x < 1.5f && n < ROWMAX; x += 0.025f)
+	{
+		xs[n] = x;
+		need[n] = f(x, 0.0f, z) <= 0.0f;
+		n++;
+	}
+
+	suite.add("f", [&](bench_state &st) {
+		size_t m = px.size() - 1;
+		for (uint64_t i = 0; i < st.iterations(); i++)
+			bench_keep(f(px[i & m], py[i & m], pz[i & m]));
+		st.set_items(st.iterations());
+	});
+	suite.add("h", [&](bench_state &st) {
+		size_t m = px.size() - 1;
+		for (uint64_t i = 0; i < st.iterations(); i++)
+			bench_keep(h(px[i & m], pz[i & m]));
+		st.set_items(st.iterations());
+	});
+	suite.add("h_row/base", [&](bench_state &st) {
+		for (uint64_t i = 0; i < st.iterations(); i++)
+		{
+			h_row_base(xs, z, need, out, n);
+			bench_clobber();
+		}
+		st.set_items(st.iterations() * n);
+	});
+	suite.add("h_row/dispatch", [&](bench_state &st) {
+		for (uint64_t i = 0; i < st.iterations(); i++)
+		{
+			h_row(xs, z, need, out, n);
+			bench_clobber();
+		}
+		st.set_items(st.iterations() * n);
+	});
+	return suite.run();
 }
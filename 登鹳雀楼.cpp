@@ -1,13 +1,13 @@
-#include<iostream>
-#include<iomanip>
-using namespace std;
+#include"text_layout.h"
 int main(void)
 {
-	cout<<setw(20)<<"ȸ¥"<<endl;
-	cout<<setw(19)<<"֮"<<endl;
-	cout<<setw(21)<<"ɽ"<<endl;
-	cout<<setw(21)<<"ƺ뺣"<<endl;
-	cout<<setw(21)<<"ǧĿ"<<endl;
-	cout<<setw(21)<<"һ¥"<<endl;
-	return 0;
+	// 32 оУźʫһд
+	TextLayout page(32,TEXT_LITERAL);
+	page.center("ȸ¥");
+	page.center("֮");
+	page.center("ɽ");
+	page.center("ƺ뺣");
+	page.center("ǧĿ");
+	page.center("һ¥");
+	return page.emit()?0:1;
 }
@@ -1,26 +1,227 @@
 #include<iostream>
 #include<iomanip>
-double Girth(double width, double height); 
+#include<vector>
+#include<cmath>
+#include<cfloat>
+#include<cstddef>
+#include<cstring>
+#include"isa_dispatch.h"
+#include"rect_index.h"
+#include"gbk_utf8.h"
+#if defined(ISA_X86_VARIANTS)
+#include<immintrin.h>
+#endif
+double Girth(double width, double height);
 double Area(double width, double height);
+double Diagonal(double width, double height);
+double Aspect(double width, double height);
 using namespace std;
-int main (void)
+
+//ṹ飺߸ռһڴ棬ʱװĴ
+struct RectBatch
 {
+	vector<double> width,height;
+	void reserve(size_t n)
+	{
+		width.reserve(n);
+		height.reserve(n);
+	}
+	void push_back(double w,double h)
+	{
+		width.push_back(w);
+		height.push_back(h);
+	}
+	size_t size() const
+	{
+		return width.size();
+	}
+};
+
+//ͬдţ i εĸڸеĵ i λ
+struct RectMetrics
+{
+	vector<double> girth,area,diagonal,aspect;
+	void resize(size_t n)
+	{
+		girth.resize(n);
+		area.resize(n);
+		diagonal.resize(n);
+		aspect.resize(n);
+	}
+};
+
+typedef void (*measure_fn)(const double *w,const double *h,size_t n,double *girth,double *area,double *diag,double *aspect);
+
+//߰汾õκ
+static void measure_base(const double *w,const double *h,size_t n,double *girth,double *area,double *diag,double *aspect)
+{
+	for(size_t i=0;i<n;i++)
+	{
+		girth[i]=Girth(w[i],h[i]);
+		area[i]=Area(w[i],h[i]);
+		diag[i]=Diagonal(w[i],h[i]);
+		aspect[i]=Aspect(w[i],h[i]);
+	}
+}
+
+//汾ÿδ 4/8 ΡԶʱƿڴҪ԰дţ
+//Խ߰ sqrt(w*w+h*h) 㣬ߵ hypot ĩλ 1 ulpƽ硢ļ Diagonal 
+#if defined(ISA_X86_VARIANTS)
+static void fix_diag(const double *w,const double *h,double *diag,unsigned bad)
+{
+	for(int k=0;bad;k++,bad>>=1)
+		if(bad&1)
+			diag[k]=Diagonal(w[k],h[k]);
+}
+
+ISA_TARGET_AVX2
+static void measure_avx2(const double *w,const double *h,size_t n,double *girth,double *area,double *diag,double *aspect)
+{
+	const __m256d two=_mm256_set1_pd(2.0);
+	const __m256d lo=_mm256_set1_pd(DBL_MIN),hi=_mm256_set1_pd(DBL_MAX);
+	size_t i=0;
+	for(;i+4<=n;i+=4)
+	{
+		__m256d vw=_mm256_loadu_pd(w+i),vh=_mm256_loadu_pd(h+i);
+		_mm256_storeu_pd(girth+i,_mm256_mul_pd(two,_mm256_add_pd(vw,vh)));
+		_mm256_storeu_pd(area+i,_mm256_mul_pd(vw,vh));
+		__m256d sq=_mm256_add_pd(_mm256_mul_pd(vw,vw),_mm256_mul_pd(vh,vh));
+		_mm256_storeu_pd(diag+i,_mm256_sqrt_pd(sq));
+		int bad=_mm256_movemask_pd(_mm256_or_pd(_mm256_cmp_pd(sq,lo,_CMP_NGE_UQ),_mm256_cmp_pd(sq,hi,_CMP_NLE_UQ)));
+		if(bad)
+			fix_diag(w+i,h+i,diag+i,bad);
+		_mm256_storeu_pd(aspect+i,_mm256_div_pd(vw,vh));
+	}
+	measure_base(w+i,h+i,n-i,girth+i,area+i,diag+i,aspect+i);
+}
+
+ISA_TARGET_AVX512
+static void measure_avx512(const double *w,const double *h,size_t n,double *girth,double *area,double *diag,double *aspect)
+{
+	const __m512d two=_mm512_set1_pd(2.0);
+	const __m512d lo=_mm512_set1_pd(DBL_MIN),hi=_mm512_set1_pd(DBL_MAX);
+	size_t i=0;
+	for(;i+8<=n;i+=8)
+	{
+		__m512d vw=_mm512_loadu_pd(w+i),vh=_mm512_loadu_pd(h+i);
+		_mm512_storeu_pd(girth+i,_mm512_mul_pd(two,_mm512_add_pd(vw,vh)));
+		_mm512_storeu_pd(area+i,_mm512_mul_pd(vw,vh));
+		__m512d sq=_mm512_add_pd(_mm512_mul_pd(vw,vw),_mm512_mul_pd(vh,vh));
+		_mm512_storeu_pd(diag+i,_mm512_mask_sqrt_pd(sq,(__mmask8)-1,sq));   //_mm512_sqrt_pd ڲδԴᴥ GCC  maybe-uninitialized
+		__mmask8 bad=_mm512_cmp_pd_mask(sq,lo,_CMP_NGE_UQ)|_mm512_cmp_pd_mask(sq,hi,_CMP_NLE_UQ);
+		if(bad)
+			fix_diag(w+i,h+i,diag+i,bad);
+		_mm512_storeu_pd(aspect+i,_mm512_div_pd(vw,vh));
+	}
+	measure_base(w+i,h+i,n-i,girth+i,area+i,diag+i,aspect+i);
+}
+#endif
+
+static measure_fn pick_measure(void)
+{
+	measure_fn avx2=0,avx512=0;
+#if defined(ISA_X86_VARIANTS)
+	avx2=measure_avx2;
+	avx512=measure_avx512;
+#endif
+	return isa_select(isa_detect(),measure_base,measure_fn(0),avx2,avx512);
+}
+
+static const measure_fn measure_rows=pick_measure();
+
+//ܳԽߺͳȣֻ㲻
+void Measure(const RectBatch &r,RectMetrics &m)
+{
+	size_t n=r.size();
+	m.resize(n);
+	measure_rows(r.width.data(),r.height.data(),n,m.girth.data(),m.area.data(),m.diagonal.data(),m.aspect.data());
+}
+
+//ֻֿʽ
+void PrintMetrics(ostream &os,const RectMetrics &m,size_t i)
+{
+	os<<fixed<<setprecision(2)<<"ܳ="<<m.girth[i]<<" ="<<m.area[i]
+	  <<" Խ="<<m.diagonal[i]<<" ="<<m.aspect[i];
+}
+
+//飺ÿһε½ߣx y w h
+//лص߽ӣľζԣŴ 0 ʼ
+int CheckOverlap(istream &is,ostream &os)
+{
+	vector<box> rects;
+	double x,y,w,h;
+	while(is>>x>>y>>w>>h)
+	{
+		box b={x,y,x+w,y+h};
+		rects.push_back(b);
+	}
+	PackedRTree tree;
+	tree.build(rects);
+	vector<uint32_t> offs,hits;
+	tree.batch_overlap(rects.data(),rects.size(),offs,hits);
+	int pairs=0;
+	for(size_t i=0;i<rects.size();i++)
+		for(uint32_t k=offs[i];k<offs[i+1];k++)
+			if(hits[k]>i)
+			{
+				os<<i<<' '<<hits[k]<<'\n';
+				pairs++;
+			}
+	return pairs;
+}
+
+void MeasureBatch(istream &is,ostream &os);
+
+int main (int argc,char *argv[])
+{
+	ConsoleText console;     //ն˱Դ벻ͬʱԶת
+	if(argc>1&&strcmp(argv[1],"--overlap")==0)
+	{
+		CheckOverlap(cin,cout);
+		return 0;
+	}
+	//--batchÿһεȫ
+	if(argc>1&&strcmp(argv[1],"--batch")==0)
+	{
+		MeasureBatch(cin,cout);
+		return 0;
+	}
 	cout<<"γ:";
 	double a,b;
 	cin>>a>>b;
-	 Girth(a,b);
-	 Area(a,b);
-	 return 0;
+	cout<<"ܳ="<<fixed<<setprecision(2)<<Girth(a,b)<<endl;
+	cout<<"="<<fixed<<setprecision(2)<<Area(a,b);
+	return 0;
 }
-double Girth(double width, double height)//ܳ 
+
+//ȶȫΣм
+void MeasureBatch(istream &is,ostream &os)
 {
-	double z;
-	z=2*(width+height);
-	cout<<"ܳ="<<fixed<<setprecision(2)<<z<<endl;
+	RectBatch r;
+	double a,b;
+	while(is>>a>>b)
+		r.push_back(a,b);
+	RectMetrics m;
+	Measure(r,m);
+	for(size_t i=0;i<r.size();i++)
+	{
+		PrintMetrics(os,m,i);
+		os<<'\n';
+	}
+}
+double Girth(double width, double height)//ܳ
+{
+	return 2*(width+height);
 }
 double Area(double width, double height)//
 {
-	double s;
-	s=width*height;
-	cout<<"="<<fixed<<setprecision(2)<<s;
-} 
+	return width*height;
+}
+double Diagonal(double width, double height)//Խ߳
+{
+	return hypot(width,height);
+}
+double Aspect(double width, double height)//㳤ȣ/ߣΪ 0 ʱõ
+{
+	return width/height;
+}
@@ -1,20 +1,83 @@
 #include<iostream>
+#include<cstring>
+#include"bench.h"
+#include"out_sink.h"
 using namespace std;
-int main(void)
+//ǰnn>=2
+void fib(int *p,int n)
 {
-	int *p=new int[20];
 	p[0]=p[1]=1;
-	int i;
-	for(i=2;i<20;i++)
+	for(int i=2;i<n;i++)
 	{
 		p[i]=p[i-1]+p[i-2];
 	}
-	for(i=0;i<20;i++)
+}
+//ÿ5
+void print(OutSink &out,const int *p,int n)
+{
+	for(int i=0;i<n;i++)
 	{
-	 cout<<p[i]<<" ";
+	 out<<p[i]<<" ";
 	 if((i+1)%5==0)
-		 cout<<endl;	
+		 out<<'\n';
 	}
+}
+int bench(int argc,char *argv[]);
+int main(int argc,char *argv[])
+{
+	//Ѳϣ --bench [--format=json ...] bench.h
+	if(argc>1&&strcmp(argv[1],"--bench")==0)
+		return bench(argc,argv);
+	int *p=new int[20];
+	OutSink out;
+	fib(p,20);
+	print(out,p,20);
 	delete []p;
+	out.flush();
 	return 0;
 }
+int bench(int argc,char *argv[])
+{
+	BenchSuite suite("fibonacci",argc,argv,2);
+	//20ǳʵĳȣ46intɵ
+	suite.add("generate/20",[](bench_state &st)
+	{
+		int p[20];
+		int *q=p;
+		int n=bench_opaque(20);         //ʱ֪ q ݣfib ᱻ
+		bench_keep(q);
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			fib(q,n);
+			bench_clobber();
+		}
+		st.set_items(st.iterations()*20);
+	});
+	suite.add("generate/46",[](bench_state &st)
+	{
+		int p[46];
+		int *q=p;
+		int n=bench_opaque(46);         //ʱ֪ q ݣfib ᱻ
+		bench_keep(q);
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			fib(q,n);
+			bench_clobber();
+		}
+		st.set_items(st.iterations()*46);
+	});
+	//·ʽOutSinkÿдһݵ豸
+	suite.add("print/20",[](bench_state &st)
+	{
+		int p[20];
+		fib(p,20);
+		OutSink out(bench_null_file());
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			print(out,p,20);
+			out.flush();
+		}
+		st.set_items(st.iterations()*20);
+	});
+	return suite.run();
+}
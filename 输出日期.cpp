@@ -1,5 +1,132 @@
 #include<iostream>
+#include<cstdio>
+#include<cstring>
+#include<cstdint>
+#include<string>
+#include<vector>
+#include"bench.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include<emmintrin.h>
+#define DATE_SSE2 1
+#endif
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define DATE_LITTLE_ENDIAN 1
+#endif
 using namespace std;
+
+typedef int32_t date_serial;        //ձʾ1970-01-014ֽ
+
+//ڹߣУ顢1970-01-01Ļ
+//ð400ڣ146097죩ʽO(1)Ҳѭ
+namespace civil
+{
+	const int MAXYEAR=1000000;      //ڡMAXYEARint
+	inline bool leap(int y)
+	{
+		return ((y%4==0)&(y%100!=0))|(y%400==0);
+	}
+	//31졢С30Ĺɣm^(m>>3)λµ
+	inline int days_in_month(int y,int m)
+	{
+		int dim=30+((m^(m>>3))&1);
+		return m==2?28+leap(y):dim;
+	}
+	inline bool valid(int y,int m,int d)
+	{
+		return ((unsigned)y+MAXYEAR<=2u*MAXYEAR)&((unsigned)(m-1)<12u)&((unsigned)(d-1)<(unsigned)days_in_month(y,m));
+	}
+	// -> 1970-01-01Ϊ
+	inline int days_from_civil(int y,int m,int d)
+	{
+		y-=m<=2;
+		int era=(y>=0?y:y-399)/400;
+		unsigned yoe=(unsigned)(y-era*400);
+		unsigned doy=(153*(m>2?m-3:m+9)+2)/5+d-1;
+		unsigned doe=yoe*365+yoe/4-yoe/100+doy;
+		return era*146097+(int)doe-719468;
+	}
+	//1970-01-01 -> 
+	inline void civil_from_days(int z,int &y,int &m,int &d)
+	{
+		z+=719468;
+		int era=(z>=0?z:z-146096)/146097;
+		unsigned doe=(unsigned)(z-era*146097);
+		unsigned yoe=(doe-doe/1460+doe/36524-doe/146096)/365;
+		unsigned doy=doe-(365*yoe+yoe/4-yoe/100);
+		unsigned mp=(5*doy+2)/153;
+		d=(int)(doy-(153*mp+2)/5+1);
+		m=(int)(mp<10?mp+3:mp-9);
+		y=(int)yoe+era*400+(m<=2);
+	}
+	//0= ... 6=
+	inline int weekday(int z)
+	{
+		return z>=-4?(z+4)%7:(z+5)%7+6;
+	}
+	//ڵڼ죬1ʼ
+	inline int day_of_year(int y,int m,int d)
+	{
+		static const short before[13]={0,0,31,59,90,120,151,181,212,243,273,304,334};
+		return before[m]+d+((m>2)&leap(y));
+	}
+
+	//"YYYY-MM-DD"ǰ8ֽһװĴֽͬʱǷΪ
+	//Ҫs10ֽڿɶ˻ֽƴͬСУ
+	inline bool parse_iso(const char *s,int &y,int &m,int &d)
+	{
+		const uint64_t ones=0x0101010101010101ull;
+		const uint64_t sepmask=0xFF0000FF00000000ull;     //47ֽΪ'-'
+		uint64_t w;
+#if defined(DATE_LITTLE_ENDIAN)
+		memcpy(&w,s,8);
+#else
+		w=0;
+		for(int k=0;k<8;k++)
+			w|=(uint64_t)(unsigned char)s[k]<<(8*k);
+#endif
+		if((w&sepmask)!=(0x2D00002D00000000ull))
+			return false;
+		uint64_t v=((w&~sepmask)|(0x30*ones&sepmask))-0x30*ones;
+		if(((v|(v+0x76*ones))&0x80*ones)!=0)
+			return false;
+		unsigned d0=(unsigned char)s[8]-'0',d1=(unsigned char)s[9]-'0';
+		if((d0>9)|(d1>9))
+			return false;
+		y=(int)((v&0xFF)*1000+((v>>8)&0xFF)*100+((v>>16)&0xFF)*10+((v>>24)&0xFF));
+		m=(int)(((v>>40)&0xFF)*10+((v>>48)&0xFF));
+		d=(int)(d0*10+d1);
+		return valid(y,m,d);
+	}
+	//"d/m/y"ա¡ÿ9λݳMAXYEARvalidܾ
+	inline bool parse_dmy(const char *s,const char *end,int &y,int &m,int &d)
+	{
+		int f[3]={0,0,0},k=0,len=0;
+		for(;s<end;s++)
+		{
+			unsigned c=(unsigned char)*s-'0';
+			if(c<10)
+			{
+				f[k]=f[k]*10+(int)c;
+				if(++len>9)
+					return false;
+			}
+			else if(*s=='/'&&len&&k<2)
+			{
+				k++;
+				len=0;
+			}
+			else
+				return false;
+		}
+		if(k!=2||!len)
+			return false;
+		d=f[0];
+		m=f[1];
+		y=f[2];
+		return valid(y,m,d);
+	}
+}
+
 class Date
 {
 	protected:
@@ -19,18 +146,325 @@ class Date
 			month=m;
 			year=y;
 		}
+		bool valid() const
+		{
+			return civil::valid(year,month,day);
+		}
+		//1970-01-01
+		date_serial serial() const
+		{
+			return civil::days_from_civil(year,month,day);
+		}
+		static Date from_serial(date_serial z)
+		{
+			Date t;
+			civil::civil_from_days(z,t.year,t.month,t.day);
+			return t;
+		}
+		int weekday() const
+		{
+			return civil::weekday(serial());
+		}
+		int yday() const
+		{
+			return civil::day_of_year(year,month,day);
+		}
+		//"YYYY-MM-DD""d/m/y"ʧʱ޸ԭֵ
+		bool parse(const char *s,size_t n)
+		{
+			int y,m,d;
+			bool ok=(n==10&&s[4]=='-')?civil::parse_iso(s,y,m,d)
+			                          :civil::parse_dmy(s,s+n,y,m,d);
+			if(ok)
+				input(d,m,y);
+			return ok;
+		}
 		void output()
 		{
 			cout<<day<<"/"<<month<<"/"<<year;
 		}
 };
-int main(void)
+
+//Уdate_serialмӼɸѡͰ·
+//Ƕint32ֱѭSSE2ʱÿδ4
+class DateColumn
 {
+	protected:
+		vector<date_serial> z;
+	public:
+		struct month_count
+		{
+			int year;
+			int month;
+			size_t count;
+		};
+		void reserve(size_t n)
+		{
+			z.reserve(n);
+		}
+		void push_back(const Date &t)
+		{
+			z.push_back(t.serial());
+		}
+		void push_back(date_serial v)
+		{
+			z.push_back(v);
+		}
+		size_t size() const
+		{
+			return z.size();
+		}
+		date_serial serial(size_t i) const
+		{
+			return z[i];
+		}
+		Date operator[](size_t i) const
+		{
+			return Date::from_serial(z[i]);
+		}
+		const date_serial *data() const
+		{
+			return z.data();
+		}
+		//мn죨nΪ
+		void add_days(int n)
+		{
+			size_t i=0,cnt=z.size();
+			date_serial *p=z.data();
+#if defined(DATE_SSE2)
+			__m128i dn=_mm_set1_epi32(n);
+			for(;i+4<=cnt;i+=4)
+				_mm_storeu_si128((__m128i*)(p+i),_mm_add_epi32(_mm_loadu_si128((const __m128i*)(p+i)),dn));
+#endif
+			for(;i<cnt;i++)
+				p[i]+=n;
+		}
+		// out[i]=this[i]-other[i]ȳ
+		void diff(const DateColumn &other,vector<int> &out) const
+		{
+			size_t i=0,cnt=z.size();
+			out.resize(cnt);
+			const date_serial *a=z.data(),*b=other.z.data();
+			int *o=out.data();
+#if defined(DATE_SSE2)
+			for(;i+4<=cnt;i+=4)
+			{
+				__m128i va=_mm_loadu_si128((const __m128i*)(a+i));
+				__m128i vb=_mm_loadu_si128((const __m128i*)(b+i));
+				_mm_storeu_si128((__m128i*)(o+i),_mm_sub_epi32(va,vb));
+			}
+#endif
+			for(;i<cnt;i++)
+				o[i]=a[i]-b[i];
+		}
+		//[lo,hi]ڵ±׷ӵidxи
+		size_t filter(const Date &lo,const Date &hi,vector<uint32_t> &idx) const
+		{
+			date_serial l=lo.serial(),h=hi.serial();
+			size_t i=0,cnt=z.size(),hit=idx.size();
+			const date_serial *p=z.data();
+#if defined(DATE_SSE2)
+			__m128i vl=_mm_set1_epi32(l-1),vh=_mm_set1_epi32(h+1);
+			for(;i+4<=cnt;i+=4)
+			{
+				__m128i v=_mm_loadu_si128((const __m128i*)(p+i));
+				__m128i in=_mm_and_si128(_mm_cmpgt_epi32(v,vl),_mm_cmplt_epi32(v,vh));
+				int bits=_mm_movemask_ps(_mm_castsi128_ps(in));
+				for(int k=0;bits;k++,bits>>=1)
+					if(bits&1)
+						idx.push_back((uint32_t)(i+k));
+			}
+#endif
+			for(;i<cnt;i++)
+				if((p[i]>=l)&(p[i]<=h))
+					idx.push_back((uint32_t)i);
+			return idx.size()-hit;
+		}
+		//ͳÿµڸʱȺ󷵻أֻгǿ·
+		vector<month_count> group_by_month() const
+		{
+			vector<month_count> out;
+			if(z.empty())
+				return out;
+			date_serial lo=z[0],hi=z[0];
+			for(size_t i=1;i<z.size();i++)
+			{
+				lo=z[i]<lo?z[i]:lo;
+				hi=z[i]>hi?z[i]:hi;
+			}
+			int y,m,d;
+			civil::civil_from_days(lo,y,m,d);
+			int base=y*12+m-1;
+			civil::civil_from_days(hi,y,m,d);
+			vector<size_t> bucket(y*12+m-base,0);
+			for(size_t i=0;i<z.size();i++)
+			{
+				civil::civil_from_days(z[i],y,m,d);
+				bucket[y*12+m-1-base]++;
+			}
+			for(size_t k=0;k<bucket.size();k++)
+			{
+				if(bucket[k])
+				{
+					month_count c;
+					int key=base+(int)k;
+					c.year=key>=0?key/12:(key-11)/12;
+					c.month=key-c.year*12+1;
+					c.count=bucket[k];
+					out.push_back(c);
+				}
+			}
+			return out;
+		}
+};
+
+//textÿһڣɻָʽؽʧܵ
+size_t parse_dates(const char *text,size_t n,vector<Date> &out)
+{
+	const char *p=text,*end=text+n;
+	size_t bad=0;
+	while(p<end)
+	{
+		const char *eol=(const char*)memchr(p,'\n',end-p);
+		if(!eol)
+			eol=end;
+		const char *q=eol;
+		if(q>p&&q[-1]=='\r')
+			q--;
+		if(q>p)
+		{
+			Date t;
+			if(t.parse(p,q-p))
+				out.push_back(t);
+			else
+				bad++;
+		}
+		p=eol+1;
+	}
+	return bad;
+}
+
+int bench(int argc,char *argv[]);
+
+int main(int argc,char *argv[])
+{
+	// --bench [] [--format=json ...]⻻㡢㣬 bench.h
+	if(argc>1&&strcmp(argv[1],"--bench")==0)
+		return bench(argc,argv);
+	static const char *week[7]={"Sun","Mon","Tue","Wed","Thu","Fri","Sat"};
 	Date x;
 	int d,m,y;
 	cout<<"please input:";
 	cin>>d>>m>>y;
 	x.input(d,m,y);
+	if(!x.valid())
+	{
+		cout<<"invalid date";
+		return 1;
+	}
 	x.output();
+	cout<<' '<<week[x.weekday()]<<" day "<<x.yday()<<" serial "<<x.serial();
 	return 0;
 }
+
+//ȡ1900~2100ĺϷڣӹ̶ıָʽռһ
+int bench(int argc,char *argv[])
+{
+	BenchSuite suite("date",argc,argv,2);
+	size_t n=suite.positional().empty()?65536:strtoul(suite.positional()[0].c_str(),0,10);
+	bench_rng rng(suite.seed());
+	date_serial lo=civil::days_from_civil(1900,1,1),hi=civil::days_from_civil(2100,12,31);
+	vector<Date> dates(n);
+	DateColumn col,other;
+	string text;
+	col.reserve(n);
+	other.reserve(n);
+	for(size_t i=0;i<n;i++)
+	{
+		dates[i]=Date::from_serial(rng.range(lo,hi));
+		col.push_back(dates[i]);
+		other.push_back(rng.range(lo,hi));
+		int y,m,d;
+		civil::civil_from_days(col.serial(i),y,m,d);
+		char buf[32];
+		if(i&1)
+			snprintf(buf,sizeof(buf),"%04d-%02d-%02d\n",y,m,d);
+		else
+			snprintf(buf,sizeof(buf),"%d/%d/%d\n",d,m,y);
+		text+=buf;
+	}
+	size_t len=text.size();                //parse_iso ֻǡΪ10ֽʱãβ
+	Date qlo(1,1,1990),qhi(31,12,1999);
+
+	suite.add("serial",[&](bench_state &st)
+	{
+		for(uint64_t i=0;i<st.iterations();i++)
+			bench_keep(dates[i%n].serial());
+		st.set_items(st.iterations());
+	});
+	suite.add("from_serial",[&](bench_state &st)
+	{
+		for(uint64_t i=0;i<st.iterations();i++)
+			bench_keep(Date::from_serial(col.serial(i%n)));
+		st.set_items(st.iterations());
+	});
+	suite.add("valid_weekday_yday",[&](bench_state &st)
+	{
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			const Date &t=dates[i%n];
+			bench_keep(t.valid()+t.weekday()+t.yday());
+		}
+		st.set_items(st.iterations());
+	});
+	suite.add("parse/"+to_string(n),[&](bench_state &st)
+	{
+		vector<Date> out;
+		out.reserve(n);
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			out.clear();
+			bench_keep(parse_dates(text.data(),len,out));
+		}
+		st.set_items(st.iterations()*n);
+		st.set_bytes(st.iterations()*len);
+	});
+	suite.add("column/add_days/"+to_string(n),[&](bench_state &st)
+	{
+		DateColumn c(col);
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			c.add_days((i&1)?-7:7);
+			bench_clobber();
+		}
+		st.set_items(st.iterations()*n);
+	});
+	suite.add("column/diff/"+to_string(n),[&](bench_state &st)
+	{
+		vector<int> out;
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			col.diff(other,out);
+			bench_clobber();
+		}
+		st.set_items(st.iterations()*n);
+	});
+	suite.add("column/filter/"+to_string(n),[&](bench_state &st)
+	{
+		vector<uint32_t> idx;
+		idx.reserve(n);
+		for(uint64_t i=0;i<st.iterations();i++)
+		{
+			idx.clear();
+			bench_keep(col.filter(qlo,qhi,idx));
+		}
+		st.set_items(st.iterations()*n);
+	});
+	suite.add("column/group_by_month/"+to_string(n),[&](bench_state &st)
+	{
+		for(uint64_t i=0;i<st.iterations();i++)
+			bench_keep(col.group_by_month().size());
+		st.set_items(st.iterations()*n);
+	});
+	return suite.run();
+}